@@ -0,0 +1,510 @@
+ /******************************************************************************
+ *
+ * Module: BOOT
+ *
+ * File Name: boot.c
+ *
+ * Description: UART bootloader of the HMI and Control ECUs, runs from the boot section
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "boot.h"
+#include "crc.h"
+#include "hash.h"
+#include "common_macros.h"
+#include <avr/interrupt.h>
+#include <avr/boot.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* U2X = 1 */
+#define BOOT_UBRR_VALUE     ((F_CPU / (8UL * BOOT_BAUD_RATE)) - 1)
+
+/* Image size, CRC and MAC */
+#define BOOT_HEADER_SIZE    (4 + HASH_DIGEST_SIZE)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+	BOOT_MODE_SYNC,     /* waiting for a sync frame */
+	BOOT_MODE_RELAY,    /* another ECU is addressed, RX is copied to TX */
+	BOOT_MODE_TARGET    /* this ECU is addressed, RX goes to the buffers */
+}Boot_ModeType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static volatile Boot_ModeType g_mode = BOOT_MODE_SYNC;
+static volatile uint8 g_syncState = 0;
+
+/* Double buffer: one page is programmed while the ISR fills the other */
+static uint8 g_buffers[2][BOOT_PAGE_SIZE];
+static volatile uint8 g_bufferFull[2];
+static volatile uint8 g_rxBuffer;
+static volatile uint8 g_rxIndex;
+static volatile uint8 g_rxExpected;
+static volatile uint8 g_rxError;
+static volatile uint8 g_activity;
+
+static const uint8 g_key[HASH_SALT_SIZE] = BOOT_KEY;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void Boot_init(void);
+static void Boot_sendByte(uint8 data);
+static void Boot_matchSync(uint8 data);
+static void Boot_resetReceiver(void);
+
+/*
+ * Wait for a sync frame, up to window_ms or forever if window_ms is 0.
+ * Returns TRUE if a sync frame was received.
+ */
+static uint8 Boot_waitSync(uint16 window_ms);
+
+/*
+ * Wait until the buffer is full.
+ * Returns FALSE on a receive error or if the line stays silent for the timeout.
+ */
+static uint8 Boot_waitBuffer(uint8 index);
+
+/*
+ * Wait until the line stays silent for the timeout.
+ */
+static void Boot_waitIdle(void);
+
+/*
+ * Run an update session as the addressed ECU.
+ * Returns TRUE if a new application was programmed and checked.
+ */
+static uint8 Boot_runSession(void);
+
+/*
+ * Erase and program one application page from a RAM buffer.
+ */
+static void Boot_programPage(uint16 address, const uint8 *data);
+
+static uint16 Boot_computeFlashCrc(uint16 size);
+
+/*
+ * Compute the MAC of the first pages of the flash, chained from the nonce, size
+ * and CRC of the header (see boot.h).
+ */
+static void Boot_computeFlashMac(const uint8 *header, uint16 pages, uint8 *mac);
+
+static uint8 Boot_isApplicationValid(void);
+static void Boot_startApplication(void);
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(USART_RXC_vect)
+{
+	uint8 status = UCSRA;
+	uint8 data = UDR;
+
+	g_activity = TRUE;
+
+	switch(g_mode)
+	{
+	case BOOT_MODE_RELAY:
+		Boot_sendByte(data);
+		break;
+
+	case BOOT_MODE_TARGET:
+		if((status & ((1<<FE) | (1<<DOR) | (1<<PE))) || g_bufferFull[g_rxBuffer])
+		{
+			/* Corrupted byte, or the tool didn't wait for the acknowledge */
+			g_rxError = TRUE;
+			break;
+		}
+		g_buffers[g_rxBuffer][g_rxIndex] = data;
+		g_rxIndex++;
+		if(g_rxIndex == g_rxExpected)
+		{
+			g_bufferFull[g_rxBuffer] = TRUE;
+			g_rxBuffer ^= 1;
+			g_rxIndex = 0;
+		}
+		break;
+
+	default:
+		Boot_matchSync(data);
+		break;
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(void)
+{
+	uint8 app_valid = Boot_isApplicationValid();
+
+	Boot_init();
+
+	while(1)
+	{
+		/* A missing or damaged application keeps the ECU in the bootloader */
+		if(!Boot_waitSync(app_valid ? BOOT_SYNC_WINDOW_MS : 0))
+		{
+			Boot_startApplication();
+		}
+
+		if(g_mode == BOOT_MODE_RELAY)
+		{
+			Boot_waitIdle();
+		}
+		else
+		{
+			app_valid = Boot_runSession();
+		}
+
+		if(app_valid)
+		{
+			Boot_startApplication();
+		}
+		Boot_resetReceiver();
+	}
+}
+
+static void Boot_init(void)
+{
+	/* Move the interrupt vectors to the boot section, the application section is rewritten */
+	GICR = (1<<IVCE);
+	GICR = (1<<IVSEL);
+
+	Boot_resetReceiver();
+
+	/* 8E1 like the application link, double speed */
+	UCSRA = (1<<U2X);
+	UCSRB = (1<<RXCIE) | (1<<RXEN) | (1<<TXEN);
+	UCSRC = (1<<URSEL) | (1<<UPM1) | (1<<UCSZ1) | (1<<UCSZ0);
+	UBRRH = (uint8)(BOOT_UBRR_VALUE >> 8);
+	UBRRL = (uint8)BOOT_UBRR_VALUE;
+
+	sei();
+}
+
+static void Boot_sendByte(uint8 data)
+{
+	while(BIT_IS_CLEAR(UCSRA,UDRE)){}
+	UDR = data;
+}
+
+static void Boot_matchSync(uint8 data)
+{
+	if((g_syncState == 0) && (data == BOOT_SYNC_1))
+	{
+		g_syncState = 1;
+	}
+	else if((g_syncState == 1) && (data == BOOT_SYNC_2))
+	{
+		g_syncState = 2;
+	}
+	else if(g_syncState == 2)
+	{
+		/* Forward the sync frame so the next ECU of the ring knows it is not addressed */
+		Boot_sendByte(BOOT_SYNC_1);
+		Boot_sendByte(BOOT_SYNC_2);
+		Boot_sendByte(data);
+		g_mode = (data == BOOT_ECU_ID) ? BOOT_MODE_TARGET : BOOT_MODE_RELAY;
+		g_syncState = 0;
+	}
+	else
+	{
+		g_syncState = (data == BOOT_SYNC_1) ? 1 : 0;
+	}
+}
+
+static void Boot_resetReceiver(void)
+{
+	cli();
+	g_mode = BOOT_MODE_SYNC;
+	g_syncState = 0;
+	g_bufferFull[0] = FALSE;
+	g_bufferFull[1] = FALSE;
+	g_rxBuffer = 0;
+	g_rxIndex = 0;
+	g_rxExpected = BOOT_HEADER_SIZE;
+	g_rxError = FALSE;
+	g_activity = FALSE;
+	sei();
+}
+
+static uint8 Boot_waitSync(uint16 window_ms)
+{
+	uint16 elapsed_ms = 0;
+
+	while(g_mode == BOOT_MODE_SYNC)
+	{
+		if(window_ms != 0)
+		{
+			if(elapsed_ms >= window_ms)
+			{
+				return FALSE;
+			}
+			elapsed_ms++;
+		}
+		_delay_ms(1);
+	}
+	return TRUE;
+}
+
+static uint8 Boot_waitBuffer(uint8 index)
+{
+	uint16 idle_ms = 0;
+
+	while(!g_bufferFull[index])
+	{
+		if(g_rxError)
+		{
+			return FALSE;
+		}
+		if(g_activity)
+		{
+			g_activity = FALSE;
+			idle_ms = 0;
+		}
+		else if(++idle_ms >= BOOT_IDLE_TIMEOUT_MS)
+		{
+			return FALSE;
+		}
+		_delay_ms(1);
+	}
+	return TRUE;
+}
+
+static void Boot_waitIdle(void)
+{
+	uint16 idle_ms = 0;
+
+	while(idle_ms < BOOT_IDLE_TIMEOUT_MS)
+	{
+		if(g_activity)
+		{
+			g_activity = FALSE;
+			idle_ms = 0;
+		}
+		else
+		{
+			idle_ms++;
+		}
+		_delay_ms(1);
+	}
+}
+
+static uint8 Boot_runSession(void)
+{
+	uint16 size;
+	uint16 crc;
+	uint16 pages;
+	uint16 page;
+	uint8 index;
+	uint32 counter;
+	uint8 header[BOOT_NONCE_SIZE + 4];
+	uint8 mac[HASH_DIGEST_SIZE];
+	uint8 expected_mac[HASH_DIGEST_SIZE];
+
+	/* The counter is saved before it is sent, a nonce is never given twice */
+	counter = eeprom_read_dword((const uint32_t *)BOOT_COUNTER_ADDRESS) + 1;
+	eeprom_update_dword((uint32_t *)BOOT_COUNTER_ADDRESS, counter);
+	eeprom_busy_wait();
+	for(index = 0; index < BOOT_NONCE_SIZE; index++)
+	{
+		header[index] = (uint8)(counter >> (8 * index));
+	}
+
+	Boot_sendByte(BOOT_ACK);
+	Boot_sendByte(BOOT_PAGE_SIZE);
+	Boot_sendByte(BOOT_APP_PAGES);
+	for(index = 0; index < BOOT_NONCE_SIZE; index++)
+	{
+		Boot_sendByte(header[index]);
+	}
+
+	if(!Boot_waitBuffer(0))
+	{
+		Boot_sendByte(BOOT_NAK);
+		return FALSE;
+	}
+	size = g_buffers[0][0] | ((uint16)g_buffers[0][1] << 8);
+	crc = g_buffers[0][2] | ((uint16)g_buffers[0][3] << 8);
+	pages = (size + (BOOT_PAGE_SIZE - 1)) / BOOT_PAGE_SIZE;
+
+	/* Keep the header, buffer 0 gets page 1 */
+	for(index = 0; index < 4; index++)
+	{
+		header[BOOT_NONCE_SIZE + index] = g_buffers[0][index];
+	}
+	for(index = 0; index < HASH_DIGEST_SIZE; index++)
+	{
+		expected_mac[index] = g_buffers[0][4 + index];
+	}
+
+	if((size == 0) || (pages > BOOT_APP_PAGES))
+	{
+		Boot_sendByte(BOOT_NAK);
+		return FALSE;
+	}
+
+	/* From now on the old application is gone, it must not start if the session fails */
+	eeprom_update_word((uint16_t *)BOOT_RECORD_SIZE_ADDRESS, 0);
+	eeprom_update_word((uint16_t *)BOOT_RECORD_CRC_ADDRESS, 0xFFFF);
+	eeprom_busy_wait();
+
+	/* The header filled buffer 0, the ISR continues with buffer 1 */
+	g_rxExpected = BOOT_PAGE_SIZE;
+	g_bufferFull[0] = FALSE;
+	index = 1;
+	Boot_sendByte(BOOT_ACK);
+
+	for(page = 0; page < pages; page++)
+	{
+		if(!Boot_waitBuffer(index))
+		{
+			Boot_sendByte(BOOT_NAK);
+			return FALSE;
+		}
+		Boot_programPage(page * BOOT_PAGE_SIZE, g_buffers[index]);
+
+		/* Free the buffer before the acknowledge, the tool reuses it for page n + 2 */
+		g_bufferFull[index] = FALSE;
+		index ^= 1;
+		Boot_sendByte(BOOT_ACK);
+		Boot_sendByte((uint8)page);
+	}
+
+	boot_rww_enable();
+	if(Boot_computeFlashCrc(size) != crc)
+	{
+		Boot_sendByte(BOOT_NAK);
+		return FALSE;
+	}
+
+	/* An image that doesn't come from a tool with the key never gets its record */
+	Boot_computeFlashMac(header, pages, mac);
+	if(!HASH_isEqual(mac, expected_mac, HASH_DIGEST_SIZE))
+	{
+		Boot_sendByte(BOOT_NAK);
+		return FALSE;
+	}
+
+	eeprom_update_word((uint16_t *)BOOT_RECORD_CRC_ADDRESS, crc);
+	eeprom_update_word((uint16_t *)BOOT_RECORD_SIZE_ADDRESS, size);
+	eeprom_busy_wait();
+	Boot_sendByte(BOOT_ACK);
+	return TRUE;
+}
+
+static void Boot_programPage(uint16 address, const uint8 *data)
+{
+	uint8 i;
+	uint16 word;
+
+	/*
+	 * The SPM instruction must follow the SPMCR write within 4 cycles, so every
+	 * command is protected from the RX interrupt. The erase and the write run
+	 * with the interrupts enabled: the CPU is only halted for the RWW section,
+	 * the bootloader and its vectors are in the NRWW section and keep receiving.
+	 */
+	for(i = 0; i < BOOT_PAGE_SIZE; i += 2)
+	{
+		word = data[i] | ((uint16)data[i + 1] << 8);
+		cli();
+		boot_page_fill(address + i, word);
+		sei();
+	}
+
+	cli();
+	boot_page_erase(address);
+	sei();
+	boot_spm_busy_wait();
+
+	cli();
+	boot_page_write(address);
+	sei();
+	boot_spm_busy_wait();
+}
+
+static uint16 Boot_computeFlashCrc(uint16 size)
+{
+	uint16 crc = CRC16_INITIAL_VALUE;
+	uint16 address;
+
+	for(address = 0; address < size; address++)
+	{
+		crc = CRC16_update(crc, pgm_read_byte(address));
+	}
+	return crc;
+}
+
+static void Boot_computeFlashMac(const uint8 *header, uint16 pages, uint8 *mac)
+{
+	uint8 state[HASH_DIGEST_SIZE];
+	uint8 data[BOOT_PAGE_SIZE];
+	uint16 page;
+	uint8 i;
+
+	/* A local copy: the ISR may still write to the page buffers */
+	HASH_compute(g_key, header, BOOT_NONCE_SIZE + 4, state);
+	for(page = 0; page < pages; page++)
+	{
+		for(i = 0; i < BOOT_PAGE_SIZE; i++)
+		{
+			data[i] = pgm_read_byte(page * BOOT_PAGE_SIZE + i);
+		}
+		HASH_compute(state, data, BOOT_PAGE_SIZE, state);
+	}
+	HASH_compute(g_key, state, HASH_DIGEST_SIZE, mac);
+}
+
+static uint8 Boot_isApplicationValid(void)
+{
+	uint16 size = eeprom_read_word((const uint16_t *)BOOT_RECORD_SIZE_ADDRESS);
+	uint16 crc = eeprom_read_word((const uint16_t *)BOOT_RECORD_CRC_ADDRESS);
+
+	/* Erased record: programmed over ISP, there is no CRC to check */
+	if((size == 0xFFFF) && (crc == 0xFFFF))
+	{
+		return (pgm_read_word(0) != 0xFFFF);
+	}
+	if((size == 0) || (size > BOOT_SECTION_START))
+	{
+		return FALSE;
+	}
+	return (Boot_computeFlashCrc(size) == crc);
+}
+
+static void Boot_startApplication(void)
+{
+	/* Let the last acknowledge leave the shift register */
+	while(BIT_IS_CLEAR(UCSRA,UDRE)){}
+	_delay_ms(1);
+
+	cli();
+	UCSRB = 0;
+	boot_rww_enable();
+
+	/* Give the interrupt vectors back to the application */
+	GICR = (1<<IVCE);
+	GICR = 0;
+
+	/* Reset vector of the application */
+	__asm__ __volatile__ ("jmp 0");
+	while(1) {}
+}
@@ -0,0 +1,111 @@
+ /******************************************************************************
+ *
+ * Module: BOOT
+ *
+ * File Name: boot.h
+ *
+ * Description: Header file for the UART bootloader of the HMI and Control ECUs
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+#include "std_types.h"
+#include <avr/io.h> /* For SPM_PAGESIZE */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The same bootloader is built for both ECUs (Release_CONTROL and Release_HMI),
+ * only the ID it answers to is different.
+ */
+#define BOOT_CONTROL_ECU_ID     'C'
+#define BOOT_HMI_ECU_ID         'H'
+
+#ifndef BOOT_ECU_ID
+#define BOOT_ECU_ID             BOOT_CONTROL_ECU_ID
+#endif
+
+/*
+ * Memory: the bootloader is linked at the start of the 4 KB boot section
+ * (fuses BOOTSZ1:0 = 00 and BOOTRST = 0), the application gets everything below it.
+ * The size and CRC of the programmed application are kept at the end of the
+ * internal EEPROM, the applications use the external one:
+ * 0xFFFF / 0xFFFF  record erased: the application was programmed over ISP, it starts
+ *                  if its reset vector is programmed (write the record at production
+ *                  to get the CRC check)
+ * 0 / any          an update was interrupted, the ECU stays in the bootloader
+ * size / CRC       the application starts if the CRC of its flash matches
+ * The session counter just below the random seed of the applications gives the
+ * nonce of every update session.
+ */
+#define BOOT_SECTION_START      0x7000
+#define BOOT_PAGE_SIZE          SPM_PAGESIZE
+#define BOOT_APP_PAGES          (BOOT_SECTION_START / BOOT_PAGE_SIZE)
+#define BOOT_RECORD_SIZE_ADDRESS 0x3FC
+#define BOOT_RECORD_CRC_ADDRESS  0x3FE
+#define BOOT_COUNTER_ADDRESS     0x3EC
+
+/* 250000 baud is exact at 8 MHz with U2X, the frame format is the link one (8E1) */
+#define BOOT_BAUD_RATE          250000UL
+
+/* After a reset the application starts if no sync frame comes within this time */
+#define BOOT_SYNC_WINDOW_MS     200
+
+/* A session ends if the line stays silent that long */
+#define BOOT_IDLE_TIMEOUT_MS    1000
+
+/*
+ * Update wiring: the service tool is inserted in the HMI <-> Control link so the
+ * three UARTs form a ring: Tool TX -> HMI RX, HMI TX -> Control RX, Control TX -> Tool RX.
+ * Every bootloader forwards the sync frame, then the one that is not addressed
+ * relays every byte from its RX to its TX. This way the HMI forwards the image
+ * to the control ECU, and the control ECU forwards the HMI replies to the tool.
+ * The tool sees its own sync frame coming back when the control ECU is addressed.
+ *
+ * Session with the addressed ECU:
+ * 1. Tool -> ECU  : BOOT_SYNC_1, BOOT_SYNC_2, ECU ID
+ * 2. ECU  -> Tool : BOOT_ACK, page size, number of application pages, nonce (4 bytes)
+ * 3. Tool -> ECU  : image size (2 bytes), image CRC-16/XMODEM (2 bytes), little endian,
+ *                   image MAC (8 bytes)
+ * 4. ECU  -> Tool : BOOT_ACK, or BOOT_NAK if the image doesn't fit
+ * 5. Tool -> ECU  : the image page by page, the last one padded with 0xFF
+ * 6. ECU  -> Tool : BOOT_ACK + page number (low byte) once the page is programmed
+ *                   the tool may send page n + 2 as soon as page n is acknowledged:
+ *                   one page is programmed while the next one is received
+ * 7. ECU  -> Tool : after the last page, BOOT_ACK if the CRC and the MAC of the
+ *                   flash match the header then the application starts,
+ *                   BOOT_NAK otherwise and the ECU stays in the bootloader
+ * Any receive error or timeout ends the session with BOOT_NAK. The application
+ * record is cleared before the first page, an interrupted update never starts.
+ *
+ * Image MAC, chained over the padded pages with the HASH of the applications:
+ * state = HASH(BOOT_KEY, nonce || size || CRC)
+ * state = HASH(state, page)               for every page, in order
+ * MAC   = HASH(BOOT_KEY, state)
+ * The nonce is a counter that moves at every session, a recorded update can't be
+ * replayed to put an older image back.
+ * Note: the pages are programmed before the MAC is checked, a tool without the key
+ * can still erase the application (the ECU then waits in the bootloader), it
+ * can't get its own image started.
+ */
+#define BOOT_SYNC_1             'B'
+#define BOOT_SYNC_2             'L'
+#define BOOT_ACK                0x06
+#define BOOT_NAK                0x15
+
+#define BOOT_NONCE_SIZE         4
+
+/*
+ * Key of the update tool: change it for every installation and keep it out of the
+ * application with the boot lock bits (BLB12 programmed, LPM from the application
+ * section can't read the boot section).
+ */
+#define BOOT_KEY                {0xC4, 0x19, 0x7E, 0x52, 0xA0, 0x3B, 0xD6, 0x8F}
+
+#endif /* BOOT_H_ */
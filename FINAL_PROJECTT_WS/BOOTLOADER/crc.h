@@ -0,0 +1,41 @@
+ /******************************************************************************
+ *
+ * Module: CRC
+ *
+ * File Name: crc.h
+ *
+ * Description: Header file for the CRC-16 used to protect stored and transferred records
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef CRC_H_
+#define CRC_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* CRC-16/XMODEM: polynomial 0x1021, initial value 0 */
+#define CRC16_INITIAL_VALUE 0x0000
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Update the CRC with one byte (avr-libc optimized implementation, no table).
+ */
+uint16 CRC16_update(uint16 crc, uint8 data);
+
+/*
+ * Description :
+ * Compute the CRC of a buffer.
+ */
+uint16 CRC16_compute(const uint8 *data, uint16 length);
+
+#endif /* CRC_H_ */
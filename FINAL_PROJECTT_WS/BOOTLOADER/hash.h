@@ -0,0 +1,48 @@
+ /******************************************************************************
+ *
+ * Module: HASH
+ *
+ * File Name: hash.h
+ *
+ * Description: Header file for the salted credential hash (HalfSipHash-2-4)
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef HASH_H_
+#define HASH_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* The salt is used as the 64-bit HalfSipHash key */
+#define HASH_SALT_SIZE      8
+
+/* HalfSipHash-2-4 with the 64-bit output variant */
+#define HASH_DIGEST_SIZE    8
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Compute the salted digest of the given data (HalfSipHash-2-4 keyed by the salt).
+ * Only 32-bit add/xor/rotate operations are used, no lookup tables, and the
+ * whole state is 16 bytes, so the kernel stays small on the AVR.
+ */
+void HASH_compute(const uint8 *salt, const uint8 *data, uint8 length, uint8 *digest);
+
+/*
+ * Description :
+ * Compare two buffers in constant time.
+ * All the bytes are always visited, so the execution time does not depend on
+ * the position of the first mismatch. Returns TRUE if the buffers are equal.
+ */
+uint8 HASH_isEqual(const uint8 *buffer1, const uint8 *buffer2, uint8 length);
+
+#endif /* HASH_H_ */
@@ -4,40 +4,91 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../auth.c \
+../bench.c \
 ../buzzer.c \
+../config.c \
 ../control_ECU_main.c \
+../crc.c \
+../credential.c \
 ../dcmotor.c \
+../door.c \
+../event_queue.c \
 ../external_eeprom.c \
 ../gpio.c \
+../hash.c \
 ../pir.c \
+../provision.c \
 ../pwm.c \
+../random.c \
+../scheduler.c \
+../storage.c \
+../supervisor.c \
+../swtimer.c \
+../system.c \
+../tick.c \
 ../timer.c \
 ../twi.c \
-../uart.c 
+../uart.c \
+../xtea.c 
 
 OBJS += \
+./auth.o \
+./bench.o \
 ./buzzer.o \
+./config.o \
 ./control_ECU_main.o \
+./crc.o \
+./credential.o \
 ./dcmotor.o \
+./door.o \
+./event_queue.o \
 ./external_eeprom.o \
 ./gpio.o \
+./hash.o \
 ./pir.o \
+./provision.o \
 ./pwm.o \
+./random.o \
+./scheduler.o \
+./storage.o \
+./supervisor.o \
+./swtimer.o \
+./system.o \
+./tick.o \
 ./timer.o \
 ./twi.o \
-./uart.o 
+./uart.o \
+./xtea.o 
 
 C_DEPS += \
+./auth.d \
+./bench.d \
 ./buzzer.d \
+./config.d \
 ./control_ECU_main.d \
+./crc.d \
+./credential.d \
 ./dcmotor.d \
+./door.d \
+./event_queue.d \
 ./external_eeprom.d \
 ./gpio.d \
+./hash.d \
 ./pir.d \
+./provision.d \
 ./pwm.d \
+./random.d \
+./scheduler.d \
+./storage.d \
+./supervisor.d \
+./swtimer.d \
+./system.d \
+./tick.d \
 ./timer.d \
 ./twi.d \
-./uart.d 
+./uart.d \
+./xtea.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
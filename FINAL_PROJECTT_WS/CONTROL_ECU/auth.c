@@ -0,0 +1,81 @@
+ /******************************************************************************
+ *
+ * Module: AUTH
+ *
+ * File Name: auth.c
+ *
+ * Description: Source file for the HMI <-> Control challenge-response authentication
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "auth.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static const uint8 g_linkKey[HASH_SALT_SIZE] = AUTH_LINK_KEY;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void AUTH_deriveSecret(const uint8 *salt, const uint8 *password, uint8 length, uint8 *secret)
+{
+	HASH_compute(salt, password, length, secret);
+}
+
+void AUTH_deriveVerifier(const uint8 *salt, const uint8 *secret, uint8 *verifier)
+{
+	HASH_compute(secret, salt, HASH_SALT_SIZE, verifier);
+}
+
+void AUTH_maskSecret(const uint8 *verifier, const uint8 *nonce, const uint8 *input, uint8 *output)
+{
+	uint8 mask[HASH_DIGEST_SIZE];
+	uint8 i;
+
+	HASH_compute(verifier, nonce, AUTH_NONCE_SIZE, mask);
+	for(i = 0; i < AUTH_SECRET_SIZE; i++)
+	{
+		output[i] = input[i] ^ mask[i];
+		mask[i] = 0;
+	}
+}
+
+void AUTH_deriveSessionKey(const uint8 *secret, const uint8 *nonce, uint8 *key)
+{
+	uint8 data[AUTH_NONCE_SIZE + 1];
+	uint8 i;
+
+	for(i = 0; i < AUTH_NONCE_SIZE; i++)
+	{
+		data[i] = nonce[i];
+	}
+	data[AUTH_NONCE_SIZE] = 1;
+	HASH_compute(secret, data, sizeof(data), key);
+	data[AUTH_NONCE_SIZE] = 2;
+	HASH_compute(secret, data, sizeof(data), key + HASH_DIGEST_SIZE);
+}
+
+void AUTH_deriveEnrollKey(const uint8 *nonce, uint8 *key)
+{
+	AUTH_deriveSessionKey(g_linkKey, nonce, key);
+}
+
+void AUTH_computeAck(const uint8 *key, const uint8 *nonce, uint8 *ack)
+{
+	uint8 i;
+
+	for(i = 0; i < AUTH_NONCE_SIZE; i++)
+	{
+		ack[i] = (uint8)~nonce[i];
+	}
+	XTEA_encrypt(key, ack);
+}
+
+void AUTH_computeMac(const uint8 *key, const uint8 *data, uint8 length, uint8 *mac)
+{
+	HASH_compute(key + (AUTH_KEY_SIZE - HASH_SALT_SIZE), data, length, mac);
+}
@@ -0,0 +1,483 @@
+ /******************************************************************************
+ *
+ * Module: BENCH
+ *
+ * File Name: bench.c
+ *
+ * Description: Source file for the cycle-count benchmark harness
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "bench.h"
+
+#if BENCH_ENABLE /* Nothing is linked in the application build */
+
+#include "timer.h"
+#include "uart.h"
+#include "hash.h"
+#include "auth.h"
+#include "credential.h"
+#include "system.h"
+#include "event_queue.h"
+#include "swtimer.h"
+#include "scheduler.h"
+#include <avr/io.h>
+#include <util/delay.h>
+#include <stdlib.h> /* For ultoa */
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Number of software timers linked in the wheel during the timer cases */
+#define BENCH_SWTIMERS         32
+
+/* Number of tasks of the scheduler cases, as many as the application */
+#define BENCH_TASKS            5
+
+/* Event queue flood: one event pushed by Timer0 at this period, for that long */
+#define BENCH_FLOOD_PERIOD_US  50UL
+#define BENCH_FLOOD_MS         100
+
+/* Size of the flooded queue, as the link receive queue */
+#define BENCH_QUEUE_SIZE       16
+
+/* Address of the last slot of the credential table, past both banks, overwritten by the EEPROM cases */
+#define BENCH_SCRATCH_ADDRESS  (CREDENTIAL_TABLE_ADDRESS + ((CREDENTIAL_SLOTS - 1) * CREDENTIAL_RECORD_SIZE))
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Outcome of one flood: every event produced is popped or dropped, never lost */
+typedef struct
+{
+	uint16 produced;
+	uint16 popped;
+	uint16 dropped;
+	uint16 disorder;    /* popped with a sequence number older than the previous one */
+}BENCH_FloodType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static volatile uint16 g_overflows = 0;
+static uint32 g_calibration = 0;
+static SwTimer_Type g_timers[BENCH_SWTIMERS + 1];
+static Scheduler_TaskType g_tasks[BENCH_TASKS];
+
+/* Counted by the dynamic timer interrupt, the same work as the system tick */
+static volatile uint32 g_interrupts = 0;
+
+/* Flooded by the Timer0 interrupt, the sequence number is the next event pushed */
+static Event_Type g_events[BENCH_QUEUE_SIZE];
+static EventQueue_Type g_queue;
+static volatile uint16 g_sequence = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Timer1 overflow callback, extends the 16-bit counter to 32 bits.
+ */
+static void BENCH_overflowCallBack(void);
+
+/*
+ * Timer0 compare match callback, dispatched through the callback pointer.
+ */
+static void BENCH_interruptCallBack(void);
+
+/*
+ * Wait for the interrupt flag then return the cycles of one window of interrupts
+ * enabled: the entry, the ISR and the return.
+ */
+static uint32 BENCH_interruptCycles(uint8 flag);
+
+/*
+ * Timer0 compare match callback, the producer of the flood.
+ */
+static void BENCH_floodCallBack(void);
+
+/*
+ * Flood the queue from Timer0 while the main loop pops, spending work x 10 us
+ * on every event popped. The queue is drained after the timer is stopped.
+ */
+static void BENCH_floodQueue(uint8 work, BENCH_FloodType *result);
+
+/*
+ * Software timer callback, never called during the measurements.
+ */
+static void BENCH_timerCallBack(void *context);
+
+/*
+ * Empty scheduler task.
+ */
+static void BENCH_task(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void BENCH_init(void)
+{
+	Timer_ConfigType bench_timer_config = {0, 0, TIMER1_ID, TIMER0_1_PRESCALER_1, NORMAL_MODE};
+
+	Timer_setCallBack(BENCH_overflowCallBack, TIMER1_ID);
+	Timer_init(&bench_timer_config);
+
+	/* Calibrate with an empty measurement */
+	g_calibration = 0;
+	BENCH_start();
+	g_calibration = BENCH_stop();
+}
+
+void BENCH_start(void)
+{
+	uint8 sreg = SREG;
+
+	SREG &= ~(1 << 7);
+	TIFR = (1 << TOV1); /* Clear any pending overflow */
+	g_overflows = 0;
+	TCNT1 = 0;
+	SREG = sreg;
+}
+
+uint32 BENCH_stop(void)
+{
+	uint8 sreg = SREG;
+	uint16 count;
+	uint16 overflows;
+	uint32 cycles;
+
+	SREG &= ~(1 << 7);
+	count = TCNT1;
+	overflows = g_overflows;
+	/* An overflow happened but its interrupt is still pending */
+	if((TIFR & (1 << TOV1)) && (count < 0x8000))
+	{
+		overflows++;
+	}
+	SREG = sreg;
+
+	cycles = ((uint32)overflows << 16) | count;
+	return (cycles > g_calibration) ? (cycles - g_calibration) : 0;
+}
+
+void BENCH_report(const char *name, uint32 cycles)
+{
+	char buff[11]; /* String to hold the ascii result */
+
+	UART_sendString((const uint8 *)name);
+	UART_sendString((const uint8 *)": ");
+	UART_sendString((const uint8 *)ultoa(cycles, buff, 10));
+	UART_sendString((const uint8 *)" cycles, ");
+	UART_sendString((const uint8 *)ultoa(cycles / (F_CPU / 1000000UL), buff, 10));
+	UART_sendString((const uint8 *)" us\r\n");
+}
+
+void BENCH_reportCount(const char *name, uint32 count)
+{
+	char buff[11]; /* String to hold the ascii result */
+
+	UART_sendString((const uint8 *)name);
+	UART_sendString((const uint8 *)": ");
+	UART_sendString((const uint8 *)ultoa(count, buff, 10));
+	UART_sendString((const uint8 *)"\r\n");
+}
+
+void BENCH_runSuite(void)
+{
+	uint8 salt[HASH_SALT_SIZE] = {0x3A, 0x91, 0x5C, 0x07, 0xE2, 0x48, 0xB6, 0x1D};
+	uint8 password[5] = {1, 2, 3, 4, 5};
+	uint8 digest[HASH_DIGEST_SIZE];
+	uint8 reference[HASH_DIGEST_SIZE];
+	uint8 nonce[AUTH_NONCE_SIZE] = {0xC4, 0x0B, 0x7E, 0x21, 0x95, 0x5F, 0xA8, 0x36};
+	uint8 key[AUTH_KEY_SIZE] = {0};
+	uint8 block[XTEA_BLOCK_SIZE] = {0};
+	uint8 secret[AUTH_SECRET_SIZE];
+	uint8 page[CREDENTIAL_RECORD_SIZE];
+	uint32 ticks;
+	uint32 deadline;
+	uint32 before;
+	uint32 asleep;
+	uint32 total;
+	uint8 i;
+
+	BENCH_init();
+
+	/* Credential hash kernel, this is what a login adds on top of the UART transfer */
+	BENCH_start();
+	HASH_compute(salt, password, sizeof(password), digest);
+	BENCH_report("hash_compute", BENCH_stop());
+
+	/* The verify cost must not depend on the position of the first mismatch */
+	for(i = 0; i < HASH_DIGEST_SIZE; i++)
+	{
+		reference[i] = digest[i];
+	}
+	reference[0] ^= 0x01;
+	BENCH_start();
+	HASH_isEqual(digest, reference, HASH_DIGEST_SIZE);
+	BENCH_report("verify_mismatch_first", BENCH_stop());
+
+	reference[0] ^= 0x01;
+	reference[HASH_DIGEST_SIZE - 1] ^= 0x01;
+	BENCH_start();
+	HASH_isEqual(digest, reference, HASH_DIGEST_SIZE);
+	BENCH_report("verify_mismatch_last", BENCH_stop());
+
+	reference[HASH_DIGEST_SIZE - 1] ^= 0x01;
+	BENCH_start();
+	HASH_isEqual(digest, reference, HASH_DIGEST_SIZE);
+	BENCH_report("verify_match", BENCH_stop());
+
+	/* Challenge-response cipher, one block each */
+	BENCH_start();
+	XTEA_encrypt(key, block);
+	BENCH_report("xtea_encrypt", BENCH_stop());
+
+	BENCH_start();
+	XTEA_decrypt(key, block);
+	BENCH_report("xtea_decrypt", BENCH_stop());
+
+	/* Control side of one login: secret unmasked and checked, session key and ack */
+	BENCH_start();
+	AUTH_maskSecret(digest, nonce, block, secret);
+	AUTH_deriveVerifier(salt, secret, reference);
+	HASH_isEqual(digest, reference, HASH_DIGEST_SIZE);
+	AUTH_deriveSessionKey(secret, nonce, key);
+	AUTH_computeAck(key, nonce, block);
+	BENCH_report("login_verify", BENCH_stop());
+
+	/* One credential record: byte writes with a fixed delay against one page write (last record is scratch) */
+	for(i = 0; i < CREDENTIAL_RECORD_SIZE; i++)
+	{
+		page[i] = i;
+	}
+	BENCH_start();
+	for(i = 0; i < CREDENTIAL_RECORD_SIZE; i++)
+	{
+		EEPROM_writeByte(BENCH_SCRATCH_ADDRESS + i, page[i]);
+		_delay_ms(10);
+	}
+	BENCH_report("record_write_bytes", BENCH_stop());
+
+	BENCH_start();
+	EEPROM_writePage(BENCH_SCRATCH_ADDRESS, page, CREDENTIAL_RECORD_SIZE);
+	EEPROM_waitReady();
+	BENCH_report("record_write_page", BENCH_stop());
+
+	/* Software timers: the cost must not depend on the number of running timers */
+	System_init();
+	for(i = 0; i < BENCH_SWTIMERS; i++)
+	{
+		/* All in the same slot, several turns ahead */
+		SwTimer_start(&g_timers[i], 1000 + ((uint32)i * SWTIMER_WHEEL_SIZE), 0, BENCH_timerCallBack, NULL_PTR);
+	}
+	BENCH_start();
+	SwTimer_start(&g_timers[BENCH_SWTIMERS], 500, 0, BENCH_timerCallBack, NULL_PTR);
+	BENCH_report("swtimer_start", BENCH_stop());
+
+	BENCH_start();
+	SwTimer_cancel(&g_timers[BENCH_SWTIMERS]);
+	BENCH_report("swtimer_cancel", BENCH_stop());
+
+	/* One tick with an empty slot, includes the tick interrupt if it hits the measurement */
+	ticks = Tick_now();
+	while(Tick_now() == ticks) {}
+	BENCH_start();
+	SwTimer_process();
+	BENCH_report("swtimer_idle_tick", BENCH_stop());
+	for(i = 0; i < BENCH_SWTIMERS; i++)
+	{
+		SwTimer_cancel(&g_timers[i]);
+	}
+
+	/* Scheduler: selection of the lowest priority task, its run and the accounting */
+	Scheduler_init();
+	for(i = 0; i < BENCH_TASKS; i++)
+	{
+		Scheduler_add(&g_tasks[i], i, BENCH_task, NULL_PTR);
+	}
+	BENCH_start();
+	Scheduler_dispatch();
+	BENCH_report("scheduler_idle_pass", BENCH_stop());
+
+	Scheduler_signal(&g_tasks[BENCH_TASKS - 1]);
+	BENCH_start();
+	Scheduler_dispatch();
+	BENCH_report("scheduler_dispatch", BENCH_stop());
+
+	/*
+	 * Timer ISR dispatch: the tick vector is bound at compile time, Timer0 goes through
+	 * the callback pointer with the same body. The difference is the cost of the
+	 * dynamic dispatch paid on every interrupt.
+	 */
+	{
+		const Timer_ConfigType dynamic_timer_config = TIMER_CTC_CONFIG(TIMER0_ID, 1000UL);
+		uint32 window;
+
+		/* Empty window: no interrupt pending */
+		SREG &= ~(1 << 7);
+		BENCH_start();
+		SREG |= (1 << 7);
+		__asm__ __volatile__ ("nop");
+		SREG &= ~(1 << 7);
+		window = BENCH_stop();
+		SREG |= (1 << 7);
+
+		BENCH_report("isr_static", BENCH_interruptCycles(1 << OCF2) - window);
+
+		Timer_setCallBack(BENCH_interruptCallBack, TIMER0_ID);
+		Timer_init(&dynamic_timer_config);
+		TIMSK &= ~(1 << OCIE2); /* Only the Timer0 interrupt in the window */
+		BENCH_report("isr_dynamic", BENCH_interruptCycles(1 << OCF0) - window);
+		TIMSK |= (1 << OCIE2);
+		Timer_deInit(TIMER0_ID);
+	}
+
+	/*
+	 * Event queue: one push and one pop with no interrupt, then a flood from the
+	 * Timer0 interrupt. With a fast consumer nothing is dropped, with a consumer
+	 * slower than the producer the queue overflows: the drops must be counted
+	 * (produced = popped + dropped) and the order kept (disorder = 0).
+	 */
+	{
+		Event_Type event = {EVENT_TIMER, 0, 0};
+		BENCH_FloodType flood;
+
+		EventQueue_init(&g_queue, g_events, BENCH_QUEUE_SIZE);
+		BENCH_start();
+		EventQueue_push(&g_queue, &event);
+		BENCH_report("event_push", BENCH_stop());
+
+		BENCH_start();
+		EventQueue_pop(&g_queue, &event);
+		BENCH_report("event_pop", BENCH_stop());
+
+		BENCH_floodQueue(0, &flood);
+		BENCH_reportCount("flood_fast_produced", flood.produced);
+		BENCH_reportCount("flood_fast_popped", flood.popped);
+		BENCH_reportCount("flood_fast_dropped", flood.dropped);
+		BENCH_reportCount("flood_fast_disorder", flood.disorder);
+
+		BENCH_floodQueue(10, &flood);
+		BENCH_reportCount("flood_slow_produced", flood.produced);
+		BENCH_reportCount("flood_slow_popped", flood.popped);
+		BENCH_reportCount("flood_slow_dropped", flood.dropped);
+		BENCH_reportCount("flood_slow_disorder", flood.disorder);
+	}
+
+	/*
+	 * Idle wait: the cycle counter keeps running in the idle sleep, so the awake time
+	 * is the total minus the time spent in System_sleep() (interrupts count as asleep).
+	 * A busy wait is awake for the whole total.
+	 */
+	asleep = 0;
+	deadline = Tick_deadline(100);
+	BENCH_start();
+	while(!Tick_isExpired(deadline))
+	{
+		before = BENCH_stop();
+		System_sleep();
+		asleep += BENCH_stop() - before;
+	}
+	total = BENCH_stop();
+	BENCH_report("wait_100ms_total", total);
+	BENCH_report("wait_100ms_awake", total - asleep);
+
+	while(1) {}
+}
+
+static void BENCH_overflowCallBack(void)
+{
+	g_overflows++;
+}
+
+static void BENCH_interruptCallBack(void)
+{
+	g_interrupts++;
+}
+
+static uint32 BENCH_interruptCycles(uint8 flag)
+{
+	uint32 cycles;
+
+	SREG &= ~(1 << 7);
+	TIFR = flag; /* Wait for a new event, not one already pending */
+	while(!(TIFR & flag)) {}
+	BENCH_start();
+	SREG |= (1 << 7);
+	__asm__ __volatile__ ("nop"); /* The pending interrupt is taken here */
+	SREG &= ~(1 << 7);
+	cycles = BENCH_stop();
+	SREG |= (1 << 7);
+	return cycles;
+}
+
+static void BENCH_timerCallBack(void *context)
+{
+	(void)context;
+}
+
+static void BENCH_task(void *context)
+{
+	(void)context;
+}
+
+static void BENCH_floodCallBack(void)
+{
+	Event_Type event = {EVENT_TIMER, 0, 0};
+
+	event.param = g_sequence++;
+	EventQueue_push(&g_queue, &event);
+}
+
+static void BENCH_floodQueue(uint8 work, BENCH_FloodType *result)
+{
+	const Timer_ConfigType flood_timer_config = TIMER_CTC_CONFIG(TIMER0_ID, BENCH_FLOOD_PERIOD_US);
+	Event_Type event;
+	uint32 deadline;
+	uint16 expected = 0;
+	uint8 running = TRUE;
+	uint8 i;
+
+	result->popped = 0;
+	result->disorder = 0;
+	EventQueue_init(&g_queue, g_events, BENCH_QUEUE_SIZE);
+	g_sequence = 0;
+	Timer_setCallBack(BENCH_floodCallBack, TIMER0_ID);
+	deadline = Tick_deadline(BENCH_FLOOD_MS);
+	Timer_init(&flood_timer_config);
+
+	while(running || !EventQueue_isEmpty(&g_queue))
+	{
+		if(running && Tick_isExpired(deadline))
+		{
+			Timer_deInit(TIMER0_ID);
+			running = FALSE;
+		}
+		if(EventQueue_pop(&g_queue, &event))
+		{
+			/* A drop leaves a gap in the sequence, it never goes back */
+			if((event.id != EVENT_TIMER) || ((uint16)(event.param - expected) >= 0x8000))
+			{
+				result->disorder++;
+			}
+			expected = event.param + 1;
+			result->popped++;
+			for(i = 0; i < work; i++)
+			{
+				_delay_us(10);
+			}
+		}
+	}
+
+	result->produced = g_sequence;
+	result->dropped = EventQueue_getDropped(&g_queue);
+}
+
+#endif /* BENCH_ENABLE */
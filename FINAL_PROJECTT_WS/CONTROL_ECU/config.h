@@ -0,0 +1,103 @@
+ /******************************************************************************
+ *
+ * Module: CONFIG
+ *
+ * File Name: config.h
+ *
+ * Description: Header file for the runtime configuration record shared by both ECUs
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Increment when the record layout changes, older records are replaced by the defaults */
+#define CONFIG_VERSION                  1
+
+/* Default values, used when the stored record is missing or corrupted */
+#define CONFIG_DEFAULT_DOOR_DURATION    15  /* seconds */
+#define CONFIG_DEFAULT_LOCKOUT_DURATION 60  /* seconds */
+#define CONFIG_DEFAULT_MAX_ATTEMPTS     3
+#define CONFIG_DEFAULT_PASSWORD_LENGTH  5
+
+/* Accepted range of the password length, buffers are sized for the maximum */
+#define CONFIG_PASSWORD_MIN_LENGTH      4
+#define CONFIG_PASSWORD_MAX_LENGTH      8
+
+/*
+ * Link requests. A configuration write is a session of the keypad password:
+ * 1. Tool    -> Control : CONFIG_WRITE_REQUEST, then the login exchange of auth.h
+ * 2. Tool    -> Control : record + MAC(session key, record), within a second of the
+ *                         acknowledge of the login
+ * 3. Control -> Tool    : AUTH_SUCCESS_SIGNAL once stored, AUTH_FAILURE_SIGNAL if the
+ *                         MAC or the record is not valid
+ */
+#define CONFIG_REQUEST                  'G' /* HMI -> Control: send the configuration */
+#define CONFIG_WRITE_REQUEST            'K' /* Tool -> Control: store a new configuration */
+
+/* Size of the record on the link and in EEPROM */
+#define CONFIG_SIZE                     (sizeof(Config_Type))
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * The record is sent and stored as is (AVR structures have no padding),
+ * the CRC-16/XMODEM covers all the fields before it and is stored little endian.
+ */
+typedef struct
+{
+	uint8 version;
+	uint8 door_operation_duration;  /* seconds for the motor to open or close the door */
+	uint8 lockout_duration;         /* seconds of lockout after too many failed logins */
+	uint8 max_attempts;
+	uint8 password_length;
+	uint16 crc;
+}Config_Type;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Configuration in use, loaded once at boot */
+extern Config_Type g_config;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Fill the record with the default values and seal it.
+ */
+void Config_setDefaults(Config_Type *config);
+
+/*
+ * Description :
+ * Compute and store the CRC of the record.
+ */
+void Config_seal(Config_Type *config);
+
+/*
+ * Description :
+ * Check the version, the CRC and the range of every field.
+ * Returns TRUE if the record can be used.
+ */
+uint8 Config_isValid(const Config_Type *config);
+
+/*
+ * Description :
+ * Send the record over UART.
+ */
+void Config_send(const Config_Type *config);
+
+#endif /* CONFIG_H_ */
@@ -1,299 +1,660 @@
-/*
- * control_ECU_main.c
- * Created on: Nov 5, 2024
- * Author: hassa
- */
-
-#include "buzzer.h"
-#include "pwm.h"
-#include "pir.h"
-#include "timer.h"
-#include "twi.h"
-#include "dcmotor.h"
-#include "uart.h"
-#include "std_types.h"
-#include "external_eeprom.h"
-#include <util/delay.h>
-
-/* EEPROM memory addresses for password storage */
-#define PASSWORD_ADDRESS_1 0x10
-#define PASSWORD_ADDRESS_2 0x15
-#define PASSWORD_ADDRESS_3 0x1A
-#define PASSWORD_ADDRESS_4 0x1F
-
-/* Signals for login status */
-#define SUCCESS_SIGNAL 0xA5
-#define FAILURE_SIGNAL 0xA6
-
-/* Password settings */
-#define PASSWORD_LENGTH 5
-#define MAX_ATTEMPTS 3
-
-/* Door operation durations in seconds */
-#define DOOR_OPERATION_DURATION 15
-#define LOCKOUT_DURATION 60
-
-/* Global variables for system state management */
-uint8 login_success = 0;
-uint8 g_count = 0;
-uint8 current_pir_state = 0xFF;
-uint8 setup_complete = 0;
-uint8 try = 0;
-uint8 renew_success = 0;
-
-/* UART, Timer, and TWI configuration structures */
-UART_ConfigType uart_config = {eight, EVEN, ONE_BIT, 9600};
-Timer_ConfigType timer_config = {0, 31250, TIMER1_ID, TIMER0_1_PRESCALER_256, CTC_MODE};
-TWI_ConfigType TWI_config = {TWI_BAUDRATE_400K, ADDRESS_1};
-
-/*
- * Callback function for timer interrupt to increment global count
- */
-void timer_callback(void) {
-	g_count++;
-}
-
-/*
- * Receives password via UART and stores it in EEPROM at specified address
- */
-void receive_and_store_password(uint16 address, uint8* password) {
-	for (uint8 i = 0; i < PASSWORD_LENGTH; i++) {
-		password[i] = UART_recieveByte();
-		EEPROM_writeByte(address + i, password[i]);
-		_delay_ms(10);
-	}
-}
-
-/*
- * Compares two passwords stored at given EEPROM addresses
- * Returns 1 if passwords match, 0 otherwise
- */
-uint8 compare_passwords(uint16 address1, uint16 address2) {
-	uint8 password1[PASSWORD_LENGTH];
-	uint8 password2[PASSWORD_LENGTH];
-
-	for (uint8 i = 0; i < PASSWORD_LENGTH; i++) {
-		EEPROM_readByte(address1 + i, &password1[i]);
-		EEPROM_readByte(address2 + i, &password2[i]);
-		_delay_ms(10);
-	}
-
-	for (uint8 i = 0; i < PASSWORD_LENGTH; i++) {
-		if (password1[i] != password2[i]) return 0;
-	}
-	return 1;
-}
-
-/*
- * Opens the door by rotating the motor in the clockwise direction
- */
-void door_open(void) {
-	g_count = 0;
-	Timer_init(&timer_config);
-	Timer_setCallBack(timer_callback, TIMER1_ID);
-	DcMotor_Rotate(CW, 100);
-
-	while (g_count < DOOR_OPERATION_DURATION) {}
-
-	DcMotor_Rotate(STOP, 0);
-	Timer_deInit(TIMER1_ID);
-}
-
-/*
- * Closes the door by rotating the motor in the anti-clockwise direction
- */
-void door_close(void) {
-	g_count = 0;
-	Timer_init(&timer_config);
-	Timer_setCallBack(timer_callback, TIMER1_ID);
-	DcMotor_Rotate(A_CW, 100);
-
-	while (g_count < DOOR_OPERATION_DURATION) {}
-
-	DcMotor_Rotate(STOP, 0);
-	Timer_deInit(TIMER1_ID);
-}
-
-/*
- * Activates the buzzer continuously until a signal to stop is received
- */
-void continuous_buzzer_alert(void) {
-	uint8 buzzer_status = UART_recieveByte();
-	while (buzzer_status == 1) {
-		Buzzer_on();
-		buzzer_status = UART_recieveByte();
-	}
-	Buzzer_off();
-}
-
-/*
- * Sets up the initial password, requiring the user to enter and re-enter it for confirmation
- */
-void setup_password(void) {
-	uint8 password[PASSWORD_LENGTH] = {0};
-	uint8 re_entered_password[PASSWORD_LENGTH] = {0};
-
-	while (!setup_complete) {
-		receive_and_store_password(PASSWORD_ADDRESS_1, password);
-		_delay_ms(500);
-		receive_and_store_password(PASSWORD_ADDRESS_2, re_entered_password);
-		_delay_ms(500);
-
-		if (compare_passwords(PASSWORD_ADDRESS_1, PASSWORD_ADDRESS_2)) {
-			UART_sendByte(1);
-			setup_complete = 1;
-		} else {
-			UART_sendByte(0);
-		}
-	}
-}
-
-/*
- * Manages the login process by receiving the login password and comparing it with the stored password
- */
-void login_password(void) {
-	uint8 login_password[PASSWORD_LENGTH] = {0};
-
-	receive_and_store_password(PASSWORD_ADDRESS_3, login_password);
-
-	if (compare_passwords(PASSWORD_ADDRESS_3, PASSWORD_ADDRESS_1)) {
-		_delay_ms(50);
-		UART_sendByte(1);
-		login_success = 1;
-	}
-	else
-	{
-		UART_sendByte(0);
-		try++;
-	}
-	if (try == MAX_ATTEMPTS)
-	{
-		try = 0;
-		g_count = 0;
-		UART_sendByte(0);
-		Timer_init(&timer_config);
-		Timer_setCallBack(timer_callback, TIMER1_ID);
-		Buzzer_on();
-		while (g_count < LOCKOUT_DURATION) {}
-		Buzzer_off();
-	}
-}
-
-/*
- * Renews the password by requiring the user to enter the current password for verification
- */
-void renew_password(void) {
-	uint8 renew_password[PASSWORD_LENGTH] = {0};
-	try = 0;
-	renew_success = 0;
-
-
-	receive_and_store_password(PASSWORD_ADDRESS_4, renew_password);
-
-	if (compare_passwords(PASSWORD_ADDRESS_4, PASSWORD_ADDRESS_1)) {
-		UART_sendByte(1);
-		renew_success = 1;
-	} else {
-		UART_sendByte(0);
-		try++;
-	}
-	if (try == MAX_ATTEMPTS) {
-		g_count = 0;
-		UART_sendByte(0);
-		Timer_init(&timer_config);
-		Timer_setCallBack(timer_callback, TIMER1_ID);
-		Buzzer_on();
-		while (g_count < LOCKOUT_DURATION) {}
-		Buzzer_off();
-		try = 0;
-	}
-
-}
-
-/*
- * Handles PIR sensor and controls the door's open and close operations based on PIR state
- */
-void handle_pir_and_door(void) {
-	current_pir_state = 0xFF;
-	uint8 pir_state;
-
-	while (1) {
-		pir_state = PIR_getState();
-
-		if (pir_state != current_pir_state) {
-			UART_sendByte(pir_state);
-			current_pir_state = pir_state;
-		}
-
-		if (pir_state == 0) {
-			UART_sendByte(0);
-			door_close();
-			break;
-		}
-	}
-}
-
-/*
- * Main function to initialize peripherals, setup password, and manage user inputs for login and password renewal
- */
-int main(void) {
-	SREG |= (1 << 7); /* Enable global interrupts */
-	TWI_init(&TWI_config);
-	UART_init(&uart_config);
-	Buzzer_init();
-	DcMotor_Init();
-	PIR_init();
-	Timer_init(&timer_config);
-	Timer_setCallBack(timer_callback, TIMER1_ID);
-
-	while (setup_complete != 1) {
-		setup_password();
-	}
-	while (1) {
-		uint8 recieverByte = 0;
-		setup_complete = 0;
-		while ((recieverByte != '+') && (recieverByte != '-')) {
-			recieverByte = UART_recieveByte();
-		};
-		switch (recieverByte) {
-		case '+':
-			g_count = 0;
-			try = 0;
-			renew_success = 0;
-			login_success = 0;
-			while (!login_success) {
-				login_password();
-				if(login_success) {
-					UART_sendByte('L');
-				} else {
-					UART_sendByte(0);
-				}
-			}
-			door_open();
-			handle_pir_and_door();
-			recieverByte = 0;
-			login_success=0;
-			break;
-
-		case '-':
-			login_success = 0;
-			g_count = 0;
-			setup_complete = 0;
-			renew_success = 0;
-			try = 0;
-			while (!renew_success)
-			{
-				renew_password();
-				if(renew_success) {
-					UART_sendByte('L');
-				} else {
-					UART_sendByte(0);
-				}
-			}
-			renew_success = 0;
-			recieverByte = 0;
-			setup_complete = 0;
-			break;
-		}
-	}
-}
+/*
+ * control_ECU_main.c
+ * Created on: Nov 5, 2024
+ * Author: hassa
+ */
+
+#include "buzzer.h"
+#include "pwm.h"
+#include "pir.h"
+#include "system.h"
+#include "scheduler.h"
+#include "storage.h"
+#include "twi.h"
+#include "dcmotor.h"
+#include "door.h"
+#include "supervisor.h"
+#include "event_queue.h"
+#include "uart.h"
+#include "std_types.h"
+#include "external_eeprom.h"
+#include "hash.h"
+#include "auth.h"
+#include "random.h"
+#include "config.h"
+#include "credential.h"
+#include "provision.h"
+#include "bench.h"
+
+/* EEPROM memory address of the configuration record */
+#define CONFIG_ADDRESS            0x00
+
+/* Task priorities, 0 runs first: the actuators before the link and its crypto work */
+#define DOOR_TASK_PRIORITY        0
+#define BUZZER_TASK_PRIORITY      1
+#define PIR_TASK_PRIORITY         2
+#define STORAGE_TASK_PRIORITY     3
+#define LINK_TASK_PRIORITY        4
+
+/*
+ * Supervisor deadlines: ready for that long without running is a stall, a run of
+ * the link task includes a key derivation. The ids of the watchdog record are the
+ * registration order: door 0, buzzer 1, PIR 2, storage 3, link 4.
+ */
+#define BUZZER_DEADLINE_MS        200
+#define PIR_DEADLINE_MS           200
+#define LINK_DEADLINE_MS          1000
+
+/* Interval of the PIR samples, a change is posted to the door */
+#define PIR_SAMPLE_PERIOD_MS      10
+
+/* Received bytes waiting for the link task, a power of 2 */
+#define LINK_RX_BUFFER_SIZE       16
+
+/* Records checked per run of the link task during a login */
+#define LINK_VERIFY_RECORDS       8
+
+/* A block not complete in that time is dropped, the HMI restarted or gave up */
+#define LINK_BLOCK_TIMEOUT_MS     1000
+
+/* Link protocol states */
+typedef enum {
+	LINK_WAIT_ENROLL,       /* no password enrolled yet */
+	LINK_ENROLL_VERIFIER,
+	LINK_MENU,              /* home menu requests */
+	LINK_CONFIG_RECORD,
+	LINK_WAIT_CHALLENGE,
+	LINK_RESPONSE,
+	LINK_VERIFY,            /* no byte expected, records checked a few per run */
+	LINK_WAIT_REKEY,
+	LINK_REKEY_VERIFIER
+} Link_State;
+
+/* Global variables for system state management */
+uint8 current_pir_state = 0xFF;  /* last PIR level sent to the HMI */
+uint8 pir_level = 0xFF;          /* last PIR level posted to the door */
+uint8 try = 0;
+uint8 session_key[AUTH_KEY_SIZE] = {0};
+uint8 session_record = CREDENTIAL_KEYPAD_INDEX; /* record that matched the last login */
+uint8 lockout_active = 0;
+
+/* Door telemetry, updated by the transition hook */
+uint16 door_cycles = 0;
+uint16 door_faults = 0;
+uint32 door_state_since = 0;
+uint32 door_state_time[DOOR_FAULT + 1]; /* total time in each state, in ms */
+
+/* Link task state */
+Link_State link_state = LINK_WAIT_ENROLL;
+uint8 link_enrolled = 0;                /* TRUE once the credential table holds a password */
+uint32 link_deadline = 0;               /* end of the block being collected */
+uint8 link_request = 0;                 /* '+', '-', CONFIG_WRITE_REQUEST or PROVISION_REQUEST during a login */
+uint8 link_block[(CONFIG_SIZE + AUTH_MAC_SIZE) > HASH_DIGEST_SIZE ? (CONFIG_SIZE + AUTH_MAC_SIZE) : HASH_DIGEST_SIZE];
+uint8 link_received = 0;
+uint8 link_expected = 0;
+uint8 link_reply[1 + AUTH_MAC_SIZE]; /* sent once the queued EEPROM writes are done */
+uint8 link_reply_length = 0;
+Credential_HeaderType link_header;
+uint8 link_nonce[AUTH_NONCE_SIZE];
+uint8 link_secret[AUTH_SECRET_SIZE];    /* unmasked by the record that matched */
+uint8 link_index = 0;                   /* next record checked by the login */
+uint8 link_matched = 0;
+
+/* Bytes received by the RX interrupt */
+Event_Type link_rx_events[LINK_RX_BUFFER_SIZE];
+EventQueue_Type link_rx_queue;
+
+/* Buzzer timing */
+uint32 buzzer_deadline = 0;
+uint8 buzzer_running = 0;
+
+/* Tasks */
+Scheduler_TaskType link_task;
+Scheduler_TaskType pir_task;
+Scheduler_TaskType buzzer_task;
+
+/* UART and TWI configuration structures */
+UART_ConfigType uart_config = {eight, EVEN, ONE_BIT, 9600};
+TWI_ConfigType TWI_config = {TWI_BAUDRATE_400K, ADDRESS_1};
+
+/*
+ * Sends a block of bytes via UART
+ */
+void send_block(const uint8* block, uint8 size) {
+	for (uint8 i = 0; i < size; i++) {
+		UART_sendByte(block[i]);
+	}
+}
+
+/*
+ * Overwrites a buffer so no secret stays in RAM
+ */
+void clear_buffer(uint8* buffer, uint8 size) {
+	for (uint8 i = 0; i < size; i++) {
+		buffer[i] = 0;
+	}
+}
+
+/*
+ * Queues a configuration record for the EEPROM
+ */
+void save_config(const Config_Type* config) {
+	/* The record fits in the first page, one write cycle instead of one per byte */
+	Storage_writePage(CONFIG_ADDRESS, config, CONFIG_SIZE);
+}
+
+/*
+ * Reads the configuration record from EEPROM once at boot
+ * A missing or corrupted record is replaced by the default configuration
+ */
+void load_config(void) {
+	uint8* bytes = (uint8*)&g_config;
+
+	for (uint8 i = 0; i < CONFIG_SIZE; i++) {
+		EEPROM_readByte(CONFIG_ADDRESS + i, &bytes[i]);
+	}
+	if (!Config_isValid(&g_config)) {
+		Config_setDefaults(&g_config);
+		save_config(&g_config);
+	}
+}
+
+/*
+ * RX complete interrupt: keeps the byte for the link task, a full buffer drops it
+ * (the HMI never sends more than one block without waiting for an answer)
+ */
+void link_receive_callback(uint8 data) {
+	Event_Type event = { EVENT_UART_RX, 0, 0 };
+
+	event.data = data;
+	EventQueue_push(&link_rx_queue, &event);
+	Scheduler_signal(&link_task);
+}
+
+/*
+ * Takes the next received byte, every byte also feeds the entropy pool
+ */
+uint8 link_pop(uint8* data) {
+	Event_Type event;
+
+	if (!EventQueue_pop(&link_rx_queue, &event)) {
+		return FALSE;
+	}
+	*data = event.data;
+	RANDOM_addEntropy(*data);
+	return TRUE;
+}
+
+/*
+ * Gives the UART receiver to the link task
+ */
+void link_start_receiving(void) {
+	EventQueue_init(&link_rx_queue, link_rx_events, LINK_RX_BUFFER_SIZE);
+	UART_setRxCallBack(link_receive_callback);
+	UART_enableRxInterrupt();
+}
+
+/*
+ * Collects the next size bytes in link_block, then the block is handled in the given state
+ */
+void link_expect(uint8 size, Link_State state) {
+	link_received = 0;
+	link_expected = size;
+	link_state = state;
+	link_deadline = Tick_deadline(LINK_BLOCK_TIMEOUT_MS);
+	Scheduler_signalAfter(&link_task, LINK_BLOCK_TIMEOUT_MS);
+}
+
+/*
+ * Returns TRUE while a block is collected in link_block
+ */
+uint8 link_collecting(void) {
+	return (link_state == LINK_ENROLL_VERIFIER) || (link_state == LINK_CONFIG_RECORD)
+			|| (link_state == LINK_RESPONSE) || (link_state == LINK_REKEY_VERIFIER);
+}
+
+/*
+ * Waits for the next request, the enrollment is only accepted while no password is enrolled
+ */
+void link_idle(void) {
+	link_state = link_enrolled ? LINK_MENU : LINK_WAIT_ENROLL;
+}
+
+/*
+ * Serves the resync requests of the HMI in both waiting states, returns FALSE if the
+ * byte is not one of them
+ */
+uint8 link_sync_request(uint8 data) {
+	if (data == CONFIG_REQUEST) {
+		Config_send(&g_config);
+	} else if (data == AUTH_STATUS_REQUEST) {
+		UART_sendByte(link_enrolled ? AUTH_SUCCESS_SIGNAL : AUTH_FAILURE_SIGNAL);
+	} else {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+ * Prepares the answer sent after the queued EEPROM writes
+ */
+void link_queue_reply(uint8 signal, const uint8* block, uint8 size) {
+	link_reply[0] = signal;
+	for (uint8 i = 0; i < size; i++) {
+		link_reply[1 + i] = block[i];
+	}
+	link_reply_length = 1 + size;
+}
+
+/*
+ * Starts the lockout: the buzzer is on for the lockout duration and the link
+ * ignores the HMI until the end
+ */
+void lockout(void) {
+	lockout_active = 1;
+	Scheduler_signal(&buzzer_task);
+}
+
+/*
+ * Door transition hook: reports the PIR to the HMI and keeps the telemetry
+ * The HMI waits for a non zero byte while somebody is detected, then for 0 0 when the door closes
+ */
+void door_transition(Door_StateType from, Door_StateType to, Door_EventType event) {
+	uint32 now = Tick_now();
+	(void)event;
+
+	door_state_time[from] += now - door_state_since;
+	door_state_since = now;
+
+	if (to == DOOR_OPENING) {
+		current_pir_state = 0xFF;
+	} else if ((to == DOOR_OPEN_HOLD) && (current_pir_state != 1)) {
+		UART_sendByte(1);
+		current_pir_state = 1;
+	} else if (to == DOOR_CLOSING) {
+		UART_sendByte(0);
+		UART_sendByte(0);
+		current_pir_state = 0;
+	} else if (to == DOOR_CLOSED) {
+		door_cycles++;
+	} else if (to == DOOR_FAULT) {
+		door_faults++;
+	}
+}
+
+/*
+ * Enrollment of the keypad password, the HMI confirms the entry locally and only sends
+ * the verifier computed with the site salt, encrypted with the enrollment key of the
+ * nonce, provisioned records are kept
+ */
+void setup_password(void) {
+	if (!Credential_loadHeader(&link_header)) {
+		/* First boot or corrupted table: new site salt, only the keypad record */
+		RANDOM_fill(link_header.salt, HASH_SALT_SIZE);
+		link_header.count = CREDENTIAL_KEYPAD_INDEX + 1;
+		link_header.bank = 0;
+	}
+	RANDOM_fill(link_nonce, AUTH_NONCE_SIZE);
+	send_block(link_header.salt, HASH_SALT_SIZE);
+	send_block(link_nonce, AUTH_NONCE_SIZE);
+	link_expect(HASH_DIGEST_SIZE, LINK_ENROLL_VERIFIER);
+}
+
+/*
+ * Stores the keypad verifier then the header, the success is sent once both are written
+ */
+void setup_password_store(void) {
+	Credential_RecordType record = {{0}};
+
+	for (uint8 i = 0; i < HASH_DIGEST_SIZE; i++) {
+		record.verifier[i] = link_block[i];
+	}
+	AUTH_deriveEnrollKey(link_nonce, session_key);
+	XTEA_decrypt(session_key, record.verifier);
+	clear_buffer(session_key, AUTH_KEY_SIZE);
+	Credential_sealHeader(&link_header);
+	Storage_writePage(CREDENTIAL_RECORD_ADDRESS(link_header.bank, CREDENTIAL_KEYPAD_INDEX), &record, sizeof(record));
+	Storage_writePage(CREDENTIAL_HEADER_ADDRESS, &link_header, sizeof(link_header));
+	clear_buffer(record.verifier, HASH_DIGEST_SIZE);
+	clear_buffer(link_block, HASH_DIGEST_SIZE);
+	link_queue_reply(AUTH_SUCCESS_SIGNAL, NULL_PTR, 0);
+	link_enrolled = 1;
+	link_state = LINK_MENU;
+}
+
+/*
+ * Receives a new configuration record from the service tool after its login, stores it
+ * if its MAC under the session key and its fields are valid and uses it from now on,
+ * the HMI gets it with its next configuration request
+ */
+void write_config(void) {
+	Config_Type* config = (Config_Type*)link_block;
+	uint8 mac[AUTH_MAC_SIZE];
+
+	AUTH_computeMac(session_key, link_block, CONFIG_SIZE, mac);
+	clear_buffer(session_key, AUTH_KEY_SIZE);
+	if (HASH_isEqual(&link_block[CONFIG_SIZE], mac, AUTH_MAC_SIZE) && Config_isValid(config)) {
+		g_config = *config;
+		save_config(&g_config);
+		link_queue_reply(AUTH_SUCCESS_SIGNAL, NULL_PTR, 0);
+	} else {
+		UART_sendByte(AUTH_FAILURE_SIGNAL);
+	}
+	link_state = LINK_MENU;
+}
+
+/*
+ * Service mode after the login of a provisioning request, with the door closed: every
+ * block is checked with the session key, the session owns the UART receiver.
+ * It blocks the other tasks for as long as the host sends blocks, they can't check in:
+ * no supervision until it ends.
+ */
+void provision_credentials(void) {
+	Supervisor_suspend();
+	Provision_run(session_key);
+	Supervisor_resume();
+	clear_buffer(session_key, AUTH_KEY_SIZE);
+	link_start_receiving();
+	link_state = LINK_MENU;
+}
+
+/*
+ * Sends the challenge of one login attempt, the HMI proves it knows the secret of the password
+ * without sending either
+ */
+void login_password(void) {
+	if (!Credential_loadHeader(&link_header)) {
+		link_header.count = 0; /* Nothing can match */
+	} else if ((link_request == CONFIG_WRITE_REQUEST) || (link_request == PROVISION_REQUEST)) {
+		link_header.count = CREDENTIAL_KEYPAD_INDEX + 1; /* Service requests: only the keypad password */
+	}
+	RANDOM_fill(link_nonce, AUTH_NONCE_SIZE);
+	send_block(link_header.salt, HASH_SALT_SIZE);
+	send_block(link_nonce, AUTH_NONCE_SIZE);
+	link_expect(AUTH_RESPONSE_SIZE, LINK_RESPONSE);
+}
+
+/*
+ * Checks the proof against a few records of the table per call: the secret unmasked
+ * with a verifier must give that verifier back
+ * Every record is tried, on success the session key stays available for a password change
+ */
+void login_verify(void) {
+	Credential_RecordType record;
+	uint8 secret[AUTH_SECRET_SIZE];
+	uint8 expected[AUTH_RESPONSE_SIZE];
+
+	/* No early exit, the time doesn't tell which record matched */
+	for (uint8 n = 0; (n < LINK_VERIFY_RECORDS) && (link_index < link_header.count); n++, link_index++) {
+		Credential_readRecord(link_header.bank, link_index, &record);
+		AUTH_maskSecret(record.verifier, link_nonce, link_block, secret);
+		AUTH_deriveVerifier(link_header.salt, secret, expected);
+		if (HASH_isEqual(record.verifier, expected, HASH_DIGEST_SIZE) && !link_matched) {
+			for (uint8 j = 0; j < AUTH_SECRET_SIZE; j++) {
+				link_secret[j] = secret[j];
+			}
+			session_record = link_index;
+			link_matched = 1;
+		}
+	}
+	clear_buffer(secret, AUTH_SECRET_SIZE);
+	clear_buffer(record.verifier, HASH_DIGEST_SIZE);
+	if (link_index < link_header.count) {
+		return; /* The link task runs again for the next records */
+	}
+
+	if (link_matched) {
+		AUTH_deriveSessionKey(link_secret, link_nonce, session_key);
+		clear_buffer(link_secret, AUTH_SECRET_SIZE);
+		AUTH_computeAck(session_key, link_nonce, expected);
+		UART_sendByte(AUTH_SUCCESS_SIGNAL);
+		send_block(expected, AUTH_RESPONSE_SIZE);
+		if (link_request == '+') {
+			clear_buffer(session_key, AUTH_KEY_SIZE);
+			Door_post(DOOR_EVENT_OPEN);
+			link_state = LINK_MENU;
+		} else if (link_request == CONFIG_WRITE_REQUEST) {
+			link_expect(CONFIG_SIZE + AUTH_MAC_SIZE, LINK_CONFIG_RECORD);
+		} else if (link_request == PROVISION_REQUEST) {
+			provision_credentials();
+		} else {
+			link_state = LINK_WAIT_REKEY;
+		}
+	} else {
+		UART_sendByte(AUTH_FAILURE_SIGNAL);
+		clear_buffer(session_key, AUTH_KEY_SIZE);
+		try++;
+		if (try < g_config.max_attempts) {
+			link_state = LINK_WAIT_CHALLENGE;
+		} else {
+			lockout();
+			link_state = LINK_MENU;
+		}
+	}
+}
+
+/*
+ * Sends the site salt for a password change of the record used for the login
+ */
+void renew_password(void) {
+	Credential_loadHeader(&link_header);
+	send_block(link_header.salt, HASH_SALT_SIZE);
+	link_expect(HASH_DIGEST_SIZE, LINK_REKEY_VERIFIER);
+}
+
+/*
+ * Replaces the password, the new verifier is received encrypted with the session key
+ * and the change is acknowledged with its MAC under the session key once the record
+ * is written
+ */
+void renew_password_store(void) {
+	Credential_RecordType record;
+	uint8 ack[AUTH_MAC_SIZE];
+
+	Credential_readRecord(link_header.bank, session_record, &record);
+	for (uint8 i = 0; i < HASH_DIGEST_SIZE; i++) {
+		record.verifier[i] = link_block[i];
+	}
+	XTEA_decrypt(session_key, record.verifier);
+	if (Storage_writePage(CREDENTIAL_RECORD_ADDRESS(link_header.bank, session_record), &record, sizeof(record))) {
+		/* Under the key of this session: an acknowledge recorded before can't be replayed */
+		AUTH_computeMac(session_key, record.verifier, HASH_DIGEST_SIZE, ack);
+		link_queue_reply(AUTH_SUCCESS_SIGNAL, ack, AUTH_MAC_SIZE);
+	} else {
+		UART_sendByte(AUTH_FAILURE_SIGNAL); /* Not queued, the password is unchanged */
+	}
+
+	clear_buffer(record.verifier, HASH_DIGEST_SIZE);
+	clear_buffer(link_block, HASH_DIGEST_SIZE);
+	clear_buffer(session_key, AUTH_KEY_SIZE);
+	link_state = LINK_MENU;
+}
+
+/*
+ * Handles one received byte in the current state of the link
+ */
+void link_handle_byte(uint8 data) {
+	switch (link_state) {
+	case LINK_WAIT_ENROLL:
+		if (data == AUTH_ENROLL_REQUEST) {
+			setup_password();
+		} else {
+			link_sync_request(data);
+		}
+		break;
+
+	case LINK_MENU:
+		/* Requests served from the home menu: door, password, HMI restart and service tool */
+		if ((data == '+') && (Door_getState() != DOOR_CLOSED)) {
+			/* Door_post() would drop the open event of the login, the HMI shows why */
+			UART_sendByte(AUTH_BUSY_SIGNAL);
+		} else if ((data == '+') || (data == '-') || (data == CONFIG_WRITE_REQUEST)
+				|| ((data == PROVISION_REQUEST) && (Door_getState() == DOOR_CLOSED))) {
+			if ((data == '+') || (data == '-')) {
+				UART_sendByte(AUTH_SUCCESS_SIGNAL);
+			}
+			link_request = data;
+			try = 0;
+			link_state = LINK_WAIT_CHALLENGE;
+		} else {
+			link_sync_request(data);
+		}
+		break;
+
+	case LINK_WAIT_CHALLENGE:
+		if (data == AUTH_CHALLENGE_REQUEST) {
+			login_password();
+		} else {
+			/* The HMI gave up the login (restart or no answer): back to waiting with this request */
+			link_idle();
+			link_handle_byte(data);
+		}
+		break;
+
+	case LINK_WAIT_REKEY:
+		if (data == AUTH_REKEY_REQUEST) {
+			renew_password();
+		} else {
+			/* The HMI gave up the change (entries that don't match): back to the menu with this request */
+			clear_buffer(session_key, AUTH_KEY_SIZE);
+			link_state = LINK_MENU;
+			link_handle_byte(data);
+		}
+		break;
+
+	default:
+		/* States collecting a block */
+		link_block[link_received++] = data;
+		if (link_received < link_expected) {
+			break;
+		}
+		if (link_state == LINK_ENROLL_VERIFIER) {
+			setup_password_store();
+		} else if (link_state == LINK_CONFIG_RECORD) {
+			write_config();
+		} else if (link_state == LINK_RESPONSE) {
+			link_index = 0;
+			link_matched = 0;
+			link_state = LINK_VERIFY;
+		} else if (link_state == LINK_REKEY_VERIFIER) {
+			renew_password_store();
+		}
+		break;
+	}
+}
+
+/*
+ * Link task: serves the HMI requests, signaled by every received byte
+ * Nothing is read while the EEPROM is written (the memory doesn't answer during its
+ * write cycle) or during the lockout, the bytes wait in the buffer
+ */
+void link_task_run(void* context) {
+	uint8 data;
+	(void)context;
+
+	if (lockout_active || !Storage_isIdle()) {
+		return; /* Signaled again by the buzzer or storage task */
+	}
+
+	if (link_reply_length != 0) {
+		send_block(link_reply, link_reply_length);
+		clear_buffer(link_reply, sizeof(link_reply));
+		link_reply_length = 0;
+	}
+
+	while ((link_state != LINK_VERIFY) && (link_reply_length == 0) && !lockout_active && link_pop(&data)) {
+		link_handle_byte(data);
+	}
+
+	if (link_collecting() && Tick_isExpired(link_deadline)) {
+		/* Nothing of a later request may fill the block, the session ends */
+		clear_buffer(link_block, sizeof(link_block));
+		clear_buffer(session_key, AUTH_KEY_SIZE);
+		link_idle();
+	}
+
+	if (link_state == LINK_VERIFY) {
+		login_verify();
+	}
+	if ((link_state == LINK_VERIFY) || (link_reply_length != 0) || !EventQueue_isEmpty(&link_rx_queue)) {
+		Scheduler_signal(&link_task);
+	}
+}
+
+/*
+ * PIR task: samples the sensor and posts every change to the door
+ */
+void pir_task_run(void* context) {
+	uint8 pir_state = PIR_getState();
+	(void)context;
+
+	if (pir_state != pir_level) {
+		pir_level = pir_state;
+		Door_post(pir_state ? DOOR_EVENT_PIR_ACTIVE : DOOR_EVENT_PIR_CLEAR);
+	}
+}
+
+/*
+ * Buzzer task: the buzzer is on for the lockout duration, then the link is released
+ */
+void buzzer_task_run(void* context) {
+	(void)context;
+
+	if (!lockout_active) {
+		return;
+	}
+	if (!buzzer_running) {
+		Buzzer_on();
+		buzzer_running = 1;
+		buzzer_deadline = Tick_deadline(TICK_SECONDS(g_config.lockout_duration));
+		Scheduler_signalAfter(&buzzer_task, TICK_SECONDS(g_config.lockout_duration));
+		return;
+	}
+	if (Tick_isExpired(buzzer_deadline)) {
+		Buzzer_off();
+		buzzer_running = 0;
+		try = 0;
+		lockout_active = 0;
+		Scheduler_signal(&link_task);
+	}
+}
+
+/*
+ * Main function to initialize peripherals and start the tasks, every request of the
+ * HMI is then served by the link task while the door, PIR and buzzer tasks run
+ */
+int main(void) {
+	Supervisor_init(); /* Completes the record of a watchdog reset */
+	RANDOM_init(); /* New entropy pool from the seed of the previous start */
+	SREG |= (1 << 7); /* Enable global interrupts */
+	TWI_init(&TWI_config);
+	UART_init(&uart_config);
+#if BENCH_ENABLE
+	BENCH_runSuite(); /* Benchmark firmware: Timer1 is used as cycle counter, never returns */
+#endif
+	Buzzer_init();
+	DcMotor_Init();
+	PIR_init();
+	System_init();
+	Scheduler_init();
+
+	Door_init(DOOR_TASK_PRIORITY, door_transition);
+	Scheduler_add(&buzzer_task, BUZZER_TASK_PRIORITY, buzzer_task_run, NULL_PTR);
+	Scheduler_supervise(&buzzer_task, BUZZER_DEADLINE_MS);
+	Scheduler_add(&pir_task, PIR_TASK_PRIORITY, pir_task_run, NULL_PTR);
+	Scheduler_supervise(&pir_task, PIR_DEADLINE_MS);
+	Scheduler_setPeriod(&pir_task, PIR_SAMPLE_PERIOD_MS);
+	Storage_init(STORAGE_TASK_PRIORITY, &link_task);
+	Scheduler_add(&link_task, LINK_TASK_PRIORITY, link_task_run, NULL_PTR);
+	Scheduler_supervise(&link_task, LINK_DEADLINE_MS);
+
+	/* Read the configuration once, the HMI requests it at every resync */
+	load_config();
+	link_enrolled = Credential_loadHeader(&link_header);
+	link_idle();
+	link_start_receiving();
+	UART_sendByte(AUTH_RESTART_SIGNAL); /* The HMI resyncs if it was waiting in an exchange */
+
+	Supervisor_start();
+	Scheduler_run();
+}
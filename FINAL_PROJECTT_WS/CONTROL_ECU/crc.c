@@ -0,0 +1,34 @@
+ /******************************************************************************
+ *
+ * Module: CRC
+ *
+ * File Name: crc.c
+ *
+ * Description: Source file for the CRC-16 used to protect stored and transferred records
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "crc.h"
+#include <util/crc16.h>
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint16 CRC16_update(uint16 crc, uint8 data)
+{
+	return _crc_xmodem_update(crc, data);
+}
+
+uint16 CRC16_compute(const uint8 *data, uint16 length)
+{
+	uint16 crc = CRC16_INITIAL_VALUE;
+
+	while(length--)
+	{
+		crc = _crc_xmodem_update(crc, *data++);
+	}
+	return crc;
+}
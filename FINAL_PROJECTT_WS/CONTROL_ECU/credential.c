@@ -0,0 +1,71 @@
+ /******************************************************************************
+ *
+ * Module: CREDENTIAL
+ *
+ * File Name: credential.c
+ *
+ * Description: Source file for the credential table stored in the external EEPROM
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "credential.h"
+#include "crc.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Number of header bytes covered by the CRC */
+#define CREDENTIAL_CRC_LENGTH   (sizeof(Credential_HeaderType) - sizeof(uint16))
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint8 Credential_loadHeader(Credential_HeaderType *header)
+{
+	if(EEPROM_readBlock(CREDENTIAL_HEADER_ADDRESS, (uint8 *)header, sizeof(Credential_HeaderType)) != SUCCESS)
+	{
+		return FALSE;
+	}
+	return (header->crc == CRC16_compute((const uint8 *)header, CREDENTIAL_CRC_LENGTH))
+			&& (header->count != 0)
+			&& (header->count <= CREDENTIAL_MAX_RECORDS)
+			&& (header->bank <= 1);
+}
+
+uint8 Credential_commitHeader(Credential_HeaderType *header)
+{
+	uint8 status;
+
+	Credential_sealHeader(header);
+	status = EEPROM_writePage(CREDENTIAL_HEADER_ADDRESS, (const uint8 *)header, sizeof(Credential_HeaderType));
+	EEPROM_waitReady();
+	return status;
+}
+
+void Credential_sealHeader(Credential_HeaderType *header)
+{
+	header->crc = CRC16_compute((const uint8 *)header, CREDENTIAL_CRC_LENGTH);
+}
+
+uint8 Credential_readRecord(uint8 bank, uint8 index, Credential_RecordType *record)
+{
+	return EEPROM_readBlock(CREDENTIAL_RECORD_ADDRESS(bank, index), (uint8 *)record, sizeof(Credential_RecordType));
+}
+
+uint8 Credential_writeRecord(uint8 bank, uint8 index, const Credential_RecordType *record)
+{
+	uint8 status;
+
+	status = Credential_startRecordWrite(bank, index, record);
+	EEPROM_waitReady();
+	return status;
+}
+
+uint8 Credential_startRecordWrite(uint8 bank, uint8 index, const Credential_RecordType *record)
+{
+	return EEPROM_writePage(CREDENTIAL_RECORD_ADDRESS(bank, index), (const uint8 *)record, sizeof(Credential_RecordType));
+}
@@ -0,0 +1,116 @@
+ /******************************************************************************
+ *
+ * Module: CREDENTIAL
+ *
+ * File Name: credential.h
+ *
+ * Description: Header file for the credential table stored in the external EEPROM
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef CREDENTIAL_H_
+#define CREDENTIAL_H_
+
+#include "std_types.h"
+#include "hash.h"
+#include "external_eeprom.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * EEPROM layout, every structure fills exactly one page so it is written in one transfer:
+ * 0x10 header (site salt, number of records, bank in use, CRC)
+ * 0x20 slot 0, 0x30 slot 1, ...
+ */
+#define CREDENTIAL_HEADER_ADDRESS   0x10
+#define CREDENTIAL_TABLE_ADDRESS    0x20
+#define CREDENTIAL_RECORD_SIZE      EEPROM_PAGE_SIZE
+#define CREDENTIAL_SLOTS            ((EEPROM_SIZE - CREDENTIAL_TABLE_ADDRESS) / CREDENTIAL_RECORD_SIZE)
+
+/* Record 0 is the password entered on the keypad, provisioned records follow it */
+#define CREDENTIAL_KEYPAD_INDEX     0
+
+/*
+ * The keypad record is in slot 0. The provisioned records are in one of two banks
+ * of slots: a provisioning session fills the bank not in use, and its header
+ * commit switches to it, so the previous table is kept until then.
+ */
+#define CREDENTIAL_BANK_RECORDS     ((CREDENTIAL_SLOTS - 1) / 2)
+#define CREDENTIAL_MAX_RECORDS      (CREDENTIAL_KEYPAD_INDEX + 1 + CREDENTIAL_BANK_RECORDS)
+
+#define CREDENTIAL_RECORD_SLOT(bank, index) \
+	(((index) == CREDENTIAL_KEYPAD_INDEX) ? 0 : \
+	(1 + ((bank) * CREDENTIAL_BANK_RECORDS) + ((index) - (CREDENTIAL_KEYPAD_INDEX + 1))))
+
+#define CREDENTIAL_RECORD_ADDRESS(bank, index) \
+	(CREDENTIAL_TABLE_ADDRESS + ((uint16)CREDENTIAL_RECORD_SLOT(bank, index) * CREDENTIAL_RECORD_SIZE))
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * All the verifiers use the same site salt: a login doesn't say which user is
+ * entering the password, so the salt sent in the challenge must fit every record.
+ */
+typedef struct
+{
+	uint8 salt[HASH_SALT_SIZE];
+	uint8 count;                /* number of valid records, the index of the table */
+	uint8 bank;                 /* bank of the provisioned records, 0 or 1 */
+	uint8 reserved[4];
+	uint16 crc;                 /* CRC-16/XMODEM of the fields before it */
+}Credential_HeaderType;
+
+typedef struct
+{
+	uint8 verifier[HASH_DIGEST_SIZE];  /* AUTH_deriveVerifier() of the site salt, see auth.h */
+	uint16 user_id;
+	uint8 flags;
+	uint8 reserved[5];
+}Credential_RecordType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Read the header of the table.
+ * Returns TRUE if its CRC, count and bank are valid, FALSE if the table must be created again.
+ */
+uint8 Credential_loadHeader(Credential_HeaderType *header);
+
+/*
+ * Description :
+ * Seal the header with its CRC and write it. This is the commit point of the table:
+ * records above the count are ignored until a header including them is written.
+ */
+uint8 Credential_commitHeader(Credential_HeaderType *header);
+
+/*
+ * Description :
+ * Compute the CRC of the header, for a header written by the storage task.
+ */
+void Credential_sealHeader(Credential_HeaderType *header);
+
+/*
+ * Description :
+ * Read/Write one record of the table, in the given bank (the one of the header
+ * for the table in use).
+ */
+uint8 Credential_readRecord(uint8 bank, uint8 index, Credential_RecordType *record);
+uint8 Credential_writeRecord(uint8 bank, uint8 index, const Credential_RecordType *record);
+
+/*
+ * Description :
+ * Start the page write of a record and return without waiting for the EEPROM
+ * write cycle, call EEPROM_waitReady() before the next access to the memory.
+ */
+uint8 Credential_startRecordWrite(uint8 bank, uint8 index, const Credential_RecordType *record);
+
+#endif /* CREDENTIAL_H_ */
@@ -0,0 +1,274 @@
+ /******************************************************************************
+ *
+ * Module: DOOR
+ *
+ * File Name: door.c
+ *
+ * Description: Source file for the door state machine
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "door.h"
+#include "scheduler.h"
+#include "swtimer.h"
+#include "tick.h"
+#include "config.h"
+#include "dcmotor.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+#define DOOR_EVENT_BIT(event)   ((uint8)(1 << (event)))
+
+/* Motor speed while the door moves, in percent */
+#define DOOR_MOTOR_SPEED        100
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static Scheduler_TaskType g_doorTask;
+static SwTimer_Type g_doorTimer;
+static Door_HookType g_hook;
+
+static Door_StateType g_state;
+static volatile uint8 g_pending;    /* one bit per posted event */
+static uint8 g_presence;            /* last PIR level posted */
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Door task: handles the posted events.
+ */
+static void Door_task(void *context);
+
+/*
+ * Handle one event in the current state.
+ */
+static void Door_handle(Door_EventType event);
+
+/*
+ * Transition: the entry action of the new state then the hook.
+ */
+static void Door_enter(Door_StateType state, Door_EventType event);
+
+/*
+ * Start the timer of the current state, it posts DOOR_EVENT_TIMEOUT.
+ */
+static void Door_arm(uint32 duration_ms);
+
+/*
+ * Software timer callback.
+ */
+static void Door_timerCallBack(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Door_init(uint8 priority, Door_HookType hook)
+{
+	g_hook = hook;
+	g_state = DOOR_CLOSED;
+	g_pending = 0;
+	g_presence = FALSE;
+	DcMotor_Rotate(STOP, 0);
+	Scheduler_add(&g_doorTask, priority, Door_task, NULL_PTR);
+	Scheduler_supervise(&g_doorTask, DOOR_DEADLINE_MS);
+}
+
+void Door_post(Door_EventType event)
+{
+	uint8 sreg = SREG;
+
+	SREG &= ~(1 << 7);
+	if(event == DOOR_EVENT_PIR_ACTIVE)
+	{
+		g_presence = TRUE;
+		g_pending &= ~DOOR_EVENT_BIT(DOOR_EVENT_PIR_CLEAR);
+	}
+	else if(event == DOOR_EVENT_PIR_CLEAR)
+	{
+		g_presence = FALSE;
+		g_pending &= ~DOOR_EVENT_BIT(DOOR_EVENT_PIR_ACTIVE);
+	}
+	g_pending |= DOOR_EVENT_BIT(event);
+	SREG = sreg;
+
+	Scheduler_signal(&g_doorTask);
+}
+
+Door_StateType Door_getState(void)
+{
+	return g_state;
+}
+
+static void Door_task(void *context)
+{
+	uint8 sreg;
+	uint8 event;
+	uint8 found;
+
+	(void)context;
+
+	do
+	{
+		/*
+		 * One event at a time, taken again from the pending bits after every
+		 * transition: a transition cancels the timeout of the previous state.
+		 * A fault first, it must stop the motor whatever else happened.
+		 */
+		found = FALSE;
+		sreg = SREG;
+		SREG &= ~(1 << 7);
+		for(event = DOOR_EVENT_FAULT + 1; !found && (event-- > 0); )
+		{
+			if(g_pending & DOOR_EVENT_BIT(event))
+			{
+				g_pending &= ~DOOR_EVENT_BIT(event);
+				found = TRUE;
+			}
+		}
+		SREG = sreg;
+
+		if(found)
+		{
+			Door_handle((Door_EventType)event);
+		}
+	} while(found);
+}
+
+static void Door_handle(Door_EventType event)
+{
+	if((event == DOOR_EVENT_FAULT) && (g_state != DOOR_FAULT))
+	{
+		Door_enter(DOOR_FAULT, event);
+		return;
+	}
+
+	switch(g_state)
+	{
+	case DOOR_CLOSED:
+		if(event == DOOR_EVENT_OPEN)
+		{
+			Door_enter(DOOR_OPENING, event);
+		}
+		break;
+
+	case DOOR_OPENING:
+		if(event == DOOR_EVENT_TIMEOUT)
+		{
+			Door_enter(g_presence ? DOOR_OPEN_HOLD : DOOR_WAIT_CLEAR, event);
+		}
+		break;
+
+	case DOOR_OPEN_HOLD:
+		if(event == DOOR_EVENT_PIR_CLEAR)
+		{
+			Door_enter(DOOR_WAIT_CLEAR, event);
+		}
+		else if(event == DOOR_EVENT_TIMEOUT)
+		{
+			Door_enter(DOOR_FAULT, event);
+		}
+		break;
+
+	case DOOR_WAIT_CLEAR:
+		if(event == DOOR_EVENT_PIR_ACTIVE)
+		{
+			Door_enter(DOOR_OPEN_HOLD, event);
+		}
+		else if(event == DOOR_EVENT_TIMEOUT)
+		{
+			Door_enter(DOOR_CLOSING, event);
+		}
+		break;
+
+	case DOOR_CLOSING:
+		if(event == DOOR_EVENT_TIMEOUT)
+		{
+			Door_enter(DOOR_CLOSED, event);
+		}
+		break;
+
+	case DOOR_FAULT:
+		if(event == DOOR_EVENT_TIMEOUT)
+		{
+			if(g_presence)
+			{
+				Door_arm(DOOR_FAULT_RETRY_MS);
+			}
+			else
+			{
+				Door_enter(DOOR_WAIT_CLEAR, event);
+			}
+		}
+		break;
+	}
+}
+
+static void Door_enter(Door_StateType state, Door_EventType event)
+{
+	Door_StateType from = g_state;
+	uint8 sreg = SREG;
+
+	/* A timeout of the previous state must not reach the new one */
+	SwTimer_cancel(&g_doorTimer);
+	SREG &= ~(1 << 7);
+	g_pending &= ~DOOR_EVENT_BIT(DOOR_EVENT_TIMEOUT);
+	SREG = sreg;
+
+	g_state = state;
+	switch(state)
+	{
+	case DOOR_OPENING:
+		DcMotor_Rotate(CW, DOOR_MOTOR_SPEED);
+		Door_arm(TICK_SECONDS(g_config.door_operation_duration));
+		break;
+
+	case DOOR_CLOSING:
+		DcMotor_Rotate(A_CW, DOOR_MOTOR_SPEED);
+		Door_arm(TICK_SECONDS(g_config.door_operation_duration));
+		break;
+
+	case DOOR_OPEN_HOLD:
+		DcMotor_Rotate(STOP, 0);
+		Door_arm(TICK_SECONDS(DOOR_HOLD_LIMIT_S));
+		break;
+
+	case DOOR_WAIT_CLEAR:
+		DcMotor_Rotate(STOP, 0);
+		Door_arm(DOOR_CLEAR_MS);
+		break;
+
+	case DOOR_FAULT:
+		DcMotor_Rotate(STOP, 0);
+		Door_arm(DOOR_FAULT_RETRY_MS);
+		break;
+
+	case DOOR_CLOSED:
+		DcMotor_Rotate(STOP, 0);
+		break;
+	}
+
+	if(g_hook != NULL_PTR)
+	{
+		g_hook(from, state, event);
+	}
+}
+
+static void Door_arm(uint32 duration_ms)
+{
+	SwTimer_start(&g_doorTimer, duration_ms, 0, Door_timerCallBack, NULL_PTR);
+}
+
+static void Door_timerCallBack(void *context)
+{
+	(void)context;
+	Door_post(DOOR_EVENT_TIMEOUT);
+}
@@ -0,0 +1,90 @@
+ /******************************************************************************
+ *
+ * Module: DOOR
+ *
+ * File Name: door.h
+ *
+ * Description: Header file for the door state machine
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef DOOR_H_
+#define DOOR_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Nobody detected for that long before the door closes (filters a PIR glitch) */
+#define DOOR_CLEAR_MS           200
+
+/* Somebody detected for that long with the door open is reported as a fault */
+#define DOOR_HOLD_LIMIT_S       300
+
+/* While in fault, the PIR is checked again at this interval before closing */
+#define DOOR_FAULT_RETRY_MS     5000
+
+/* Supervisor deadline of the task, its runs only switch the motor and the timer */
+#define DOOR_DEADLINE_MS        200
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * CLOSED ----OPEN----> OPENING ---TIMEOUT---> OPEN_HOLD (somebody detected)
+ *                                         \-> WAIT_CLEAR (nobody detected)
+ * OPEN_HOLD  ---PIR_CLEAR---> WAIT_CLEAR ---TIMEOUT---> CLOSING ---TIMEOUT---> CLOSED
+ * WAIT_CLEAR ---PIR_ACTIVE--> OPEN_HOLD
+ * OPEN_HOLD  ---TIMEOUT (hold limit)---> FAULT
+ * any state  ---FAULT-------------------> FAULT (motor stopped)
+ * FAULT      ---TIMEOUT, nobody detected-> WAIT_CLEAR
+ * The motor runs for the door operation duration of the configuration.
+ */
+typedef enum
+{
+	DOOR_CLOSED, DOOR_OPENING, DOOR_OPEN_HOLD, DOOR_WAIT_CLEAR, DOOR_CLOSING, DOOR_FAULT
+}Door_StateType;
+
+typedef enum
+{
+	DOOR_EVENT_OPEN,            /* successful login */
+	DOOR_EVENT_TIMEOUT,         /* timer of the current state */
+	DOOR_EVENT_PIR_ACTIVE,      /* somebody detected */
+	DOOR_EVENT_PIR_CLEAR,       /* nobody detected */
+	DOOR_EVENT_FAULT            /* from a supervisor */
+}Door_EventType;
+
+/* Called after every transition, from the door task */
+typedef void (*Door_HookType)(Door_StateType from, Door_StateType to, Door_EventType event);
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Add the door task to the scheduler, the door is CLOSED with the motor stopped.
+ * The hook (may be NULL_PTR) observes the transitions, e.g. for telemetry.
+ */
+void Door_init(uint8 priority, Door_HookType hook);
+
+/*
+ * Description :
+ * Post an event to the door task, it is handled in its next run.
+ * The events of the same kind posted before that run are handled once,
+ * for the PIR the last level posted wins.
+ */
+void Door_post(Door_EventType event);
+
+/*
+ * Description :
+ * Return the current state.
+ */
+Door_StateType Door_getState(void);
+
+#endif /* DOOR_H_ */
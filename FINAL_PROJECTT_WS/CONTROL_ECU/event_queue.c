@@ -0,0 +1,92 @@
+ /******************************************************************************
+ *
+ * Module: EVENT_QUEUE
+ *
+ * File Name: event_queue.c
+ *
+ * Description: Source file for the lock-free single-producer single-consumer event queue
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "event_queue.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/*
+ * Compiler barrier: the record is copied before the index that publishes it is
+ * written (and read after the index is read). The AVR core doesn't reorder memory
+ * accesses, only the compiler has to be stopped.
+ */
+#define EVENT_QUEUE_BARRIER()   __asm__ __volatile__ ("" ::: "memory")
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void EventQueue_init(EventQueue_Type *queue, Event_Type *buffer, uint8 size)
+{
+	queue->buffer = buffer;
+	queue->mask = size - 1;
+	queue->head = 0;
+	queue->tail = 0;
+	queue->dropped = 0;
+}
+
+uint8 EventQueue_push(EventQueue_Type *queue, const Event_Type *event)
+{
+	uint8 head = queue->head;
+
+	/* Free running indexes: the difference is the number of waiting events */
+	if((uint8)(head - queue->tail) > queue->mask)
+	{
+		queue->dropped++;
+		return FALSE;
+	}
+
+	queue->buffer[head & queue->mask] = *event;
+	EVENT_QUEUE_BARRIER();
+	queue->head = head + 1;
+	return TRUE;
+}
+
+uint8 EventQueue_pop(EventQueue_Type *queue, Event_Type *event)
+{
+	uint8 tail = queue->tail;
+
+	if(tail == queue->head)
+	{
+		return FALSE;
+	}
+
+	EVENT_QUEUE_BARRIER();
+	*event = queue->buffer[tail & queue->mask];
+	EVENT_QUEUE_BARRIER();
+	queue->tail = tail + 1;
+	return TRUE;
+}
+
+uint8 EventQueue_isEmpty(const EventQueue_Type *queue)
+{
+	return (queue->tail == queue->head);
+}
+
+void EventQueue_flush(EventQueue_Type *queue)
+{
+	queue->tail = queue->head;
+}
+
+uint16 EventQueue_getDropped(const EventQueue_Type *queue)
+{
+	uint16 dropped;
+
+	/* 2 bytes written by the producer: read again until no push came in between */
+	do
+	{
+		dropped = queue->dropped;
+	} while(dropped != queue->dropped);
+	return dropped;
+}
@@ -0,0 +1,104 @@
+ /******************************************************************************
+ *
+ * Module: EVENT_QUEUE
+ *
+ * File Name: event_queue.h
+ *
+ * Description: Header file for the lock-free single-producer single-consumer event queue
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef EVENT_QUEUE_H_
+#define EVENT_QUEUE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Largest queue: the indexes are free running 8-bit counters */
+#define EVENT_QUEUE_MAX_SIZE    128
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+	EVENT_NONE,
+	EVENT_UART_RX,          /* data: received byte */
+	EVENT_TIMER,            /* param: sequence number of the producer */
+	EVENT_KEY_PRESS,        /* data: key code */
+	EVENT_KEY_RELEASE,      /* data: key code */
+	EVENT_KEY_LONG_PRESS    /* data: key code */
+}Event_IdType;
+
+typedef struct
+{
+	uint8 id;               /* Event_IdType */
+	uint8 data;
+	uint16 param;
+}Event_Type;
+
+/*
+ * The producer only writes head and dropped, the consumer only writes tail: with
+ * 8-bit indexes every access is a single load or store, so neither side disables
+ * the interrupts. The producer is the interrupt context (AVR interrupts don't nest,
+ * so several ISRs act as one producer) or a single task, never both.
+ * The queue and its buffer are owned by the application.
+ */
+typedef struct
+{
+	Event_Type *buffer;
+	uint8 mask;             /* size - 1, the size is a power of 2 */
+	volatile uint8 head;    /* next slot written by the producer */
+	volatile uint8 tail;    /* next slot read by the consumer */
+	volatile uint16 dropped;
+}EventQueue_Type;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Attach the buffer, size is a power of 2 up to EVENT_QUEUE_MAX_SIZE.
+ * Call it before the producer is started.
+ */
+void EventQueue_init(EventQueue_Type *queue, Event_Type *buffer, uint8 size);
+
+/*
+ * Description :
+ * Producer side: copy the event to the queue.
+ * Returns FALSE and counts the event as dropped if the queue is full.
+ */
+uint8 EventQueue_push(EventQueue_Type *queue, const Event_Type *event);
+
+/*
+ * Description :
+ * Consumer side: take the oldest event. Returns FALSE if the queue is empty.
+ */
+uint8 EventQueue_pop(EventQueue_Type *queue, Event_Type *event);
+
+/*
+ * Description :
+ * Consumer side: return TRUE if no event is waiting.
+ */
+uint8 EventQueue_isEmpty(const EventQueue_Type *queue);
+
+/*
+ * Description :
+ * Consumer side: discard the waiting events.
+ */
+void EventQueue_flush(EventQueue_Type *queue);
+
+/*
+ * Description :
+ * Return the number of events dropped since the init, read without a lock.
+ */
+uint16 EventQueue_getDropped(const EventQueue_Type *queue);
+
+#endif /* EVENT_QUEUE_H_ */
@@ -1,32 +1,59 @@
- /******************************************************************************
- *
- * Module: External EEPROM
- *
- * File Name: external_eeprom.h
- *
- * Description: Header file for the External EEPROM Memory
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-
-
-#ifndef EXTERNAL_EEPROM_H_
-#define EXTERNAL_EEPROM_H_
-
-#include "std_types.h"
-
-/*******************************************************************************
- *                      Preprocessor Macros                                    *
- *******************************************************************************/
-#define ERROR 0
-#define SUCCESS 1
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
-uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data);
- 
-#endif /* EXTERNAL_EEPROM_H_ */
+ /******************************************************************************
+ *
+ * Module: External EEPROM
+ *
+ * File Name: external_eeprom.h
+ *
+ * Description: Header file for the External EEPROM Memory
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+
+
+#ifndef EXTERNAL_EEPROM_H_
+#define EXTERNAL_EEPROM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+#define ERROR 0
+#define SUCCESS 1
+
+/* 24C16: 2 KB organized in pages of 16 bytes */
+#define EEPROM_SIZE      2048
+#define EEPROM_PAGE_SIZE 16
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
+uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data);
+
+/*
+ * Write up to one page in a single transfer, the data must not cross a page boundary.
+ * The memory is busy for its internal write cycle after it, see EEPROM_waitReady.
+ */
+uint8 EEPROM_writePage(uint16 u16addr,const uint8 *data,uint8 length);
+
+/*
+ * Sequential read of a block of bytes in a single transfer.
+ */
+uint8 EEPROM_readBlock(uint16 u16addr,uint8 *data,uint16 length);
+
+/*
+ * Wait for the end of the internal write cycle (acknowledge polling),
+ * usually shorter than a fixed delay.
+ */
+void EEPROM_waitReady(void);
+
+/*
+ * One acknowledge poll: TRUE once the internal write cycle is done, so a task
+ * can check it again later instead of waiting.
+ */
+uint8 EEPROM_isReady(void);
+ 
+#endif /* EXTERNAL_EEPROM_H_ */
@@ -0,0 +1,131 @@
+ /******************************************************************************
+ *
+ * Module: HASH
+ *
+ * File Name: hash.c
+ *
+ * Description: Source file for the salted credential hash (HalfSipHash-2-4)
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "hash.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Rotate a 32-bit word left, rotations by 8 and 16 become byte moves on the AVR */
+#define HASH_ROTL32(x,b) (uint32)(((x) << (b)) | ((x) >> (32 - (b))))
+
+/* Little endian load of a 32-bit word from a byte array */
+#define HASH_LOAD32(p) (((uint32)((p)[0])) | ((uint32)((p)[1]) << 8) | \
+		((uint32)((p)[2]) << 16) | ((uint32)((p)[3]) << 24))
+
+#define HASH_C_ROUNDS 2
+#define HASH_D_ROUNDS 4
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Apply the given number of SipRounds on the 4 words state.
+ */
+static void HASH_sipRounds(uint32 *v, uint8 rounds);
+
+/*
+ * Store a 32-bit word in little endian order.
+ */
+static void HASH_store32(uint8 *p, uint32 value);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void HASH_compute(const uint8 *salt, const uint8 *data, uint8 length, uint8 *digest)
+{
+	uint32 v[4];
+	uint32 k0 = HASH_LOAD32(salt);
+	uint32 k1 = HASH_LOAD32(salt + 4);
+	uint32 m;
+	uint32 b = ((uint32)length) << 24;
+	uint8 left = length & 3;
+	const uint8 *end = data + length - left;
+
+	v[0] = k0;
+	v[1] = k1 ^ 0xEE; /* 64-bit output variant */
+	v[2] = k0 ^ 0x6C796765UL;
+	v[3] = k1 ^ 0x74656462UL;
+
+	/* Compression of the full 4 bytes blocks */
+	for(; data != end; data += 4)
+	{
+		m = HASH_LOAD32(data);
+		v[3] ^= m;
+		HASH_sipRounds(v, HASH_C_ROUNDS);
+		v[0] ^= m;
+	}
+
+	/* Last block holds the remaining bytes and the message length */
+	switch(left)
+	{
+	case 3:
+		b |= ((uint32)data[2]) << 16;
+		/* fall through */
+	case 2:
+		b |= ((uint32)data[1]) << 8;
+		/* fall through */
+	case 1:
+		b |= ((uint32)data[0]);
+		break;
+	}
+	v[3] ^= b;
+	HASH_sipRounds(v, HASH_C_ROUNDS);
+	v[0] ^= b;
+
+	/* Finalization, two rounds of output words */
+	v[2] ^= 0xEE;
+	HASH_sipRounds(v, HASH_D_ROUNDS);
+	HASH_store32(digest, v[1] ^ v[3]);
+
+	v[1] ^= 0xDD;
+	HASH_sipRounds(v, HASH_D_ROUNDS);
+	HASH_store32(digest + 4, v[1] ^ v[3]);
+}
+
+uint8 HASH_isEqual(const uint8 *buffer1, const uint8 *buffer2, uint8 length)
+{
+	uint8 i;
+	uint8 difference = 0;
+
+	/* No early exit: accumulate the difference of all the bytes */
+	for(i = 0; i < length; i++)
+	{
+		difference |= buffer1[i] ^ buffer2[i];
+	}
+	return (difference == 0);
+}
+
+static void HASH_sipRounds(uint32 *v, uint8 rounds)
+{
+	uint32 v0 = v[0], v1 = v[1], v2 = v[2], v3 = v[3];
+
+	while(rounds--)
+	{
+		v0 += v1; v1 = HASH_ROTL32(v1, 5);  v1 ^= v0; v0 = HASH_ROTL32(v0, 16);
+		v2 += v3; v3 = HASH_ROTL32(v3, 8);  v3 ^= v2;
+		v0 += v3; v3 = HASH_ROTL32(v3, 7);  v3 ^= v0;
+		v2 += v1; v1 = HASH_ROTL32(v1, 13); v1 ^= v2; v2 = HASH_ROTL32(v2, 16);
+	}
+	v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+}
+
+static void HASH_store32(uint8 *p, uint32 value)
+{
+	p[0] = (uint8)(value);
+	p[1] = (uint8)(value >> 8);
+	p[2] = (uint8)(value >> 16);
+	p[3] = (uint8)(value >> 24);
+}
@@ -0,0 +1,247 @@
+ /******************************************************************************
+ *
+ * Module: PROVISION
+ *
+ * File Name: provision.c
+ *
+ * Description: Source file for the bulk credential provisioning over UART
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "provision.h"
+#include "auth.h"
+#include "uart.h"
+#include "system.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+#define PROVISION_FRAME_HEADER_SIZE 2   /* seq, n */
+#define PROVISION_FRAME_MAC_SIZE    AUTH_MAC_SIZE
+#define PROVISION_FRAME_MAX_SIZE    (PROVISION_FRAME_HEADER_SIZE \
+		+ (PROVISION_BLOCK_RECORDS * CREDENTIAL_RECORD_SIZE) + PROVISION_FRAME_MAC_SIZE)
+
+/* Line silence needed before giving the UART back after an aborted session */
+#define PROVISION_DRAIN_MS          20
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Double buffer: one frame is written to EEPROM while the ISR fills the other */
+static uint8 g_frames[2][PROVISION_FRAME_MAX_SIZE];
+static volatile uint8 g_frameLength[2];  /* 0 while the buffer is free or being filled */
+
+/* Receive state, only changed by the RX callback once the session started */
+static volatile uint8 g_rxFrame;
+static volatile uint8 g_rxIndex;
+static volatile uint8 g_rxExpected;
+static volatile uint8 g_receiving;
+static volatile uint8 g_rxError;
+static volatile uint8 g_draining;
+static volatile uint8 g_activity;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * RX complete callback, assembles the frames in the free buffer.
+ */
+static void Provision_receiveCallBack(uint8 data);
+
+/*
+ * Wait for the next complete frame.
+ * Returns FALSE on a receive error or if the host stays silent for the timeout.
+ */
+static uint8 Provision_waitFrame(uint8 frame_index);
+
+/*
+ * Wait until the line is silent then stop receiving.
+ */
+static void Provision_drain(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint8 Provision_run(const uint8 *key)
+{
+	Credential_HeaderType header;
+	uint8 mac[PROVISION_FRAME_MAC_SIZE];
+	uint8 *frame;
+	uint8 length;
+	uint8 count;
+	uint8 i;
+	uint8 frame_index = 0;
+	uint8 seq = 0;
+	uint8 next_record = CREDENTIAL_KEYPAD_INDEX + 1;
+	uint8 bank;
+	uint8 committed = FALSE;
+	uint8 valid;
+
+	if(!Credential_loadHeader(&header))
+	{
+		return FALSE; /* No keypad password, so no login could start the session */
+	}
+
+	/* The table in use stays valid until the header switching to the other bank */
+	bank = header.bank ^ 1;
+
+	g_frameLength[0] = 0;
+	g_frameLength[1] = 0;
+	g_rxFrame = 0;
+	g_receiving = FALSE;
+	g_rxError = FALSE;
+	g_draining = FALSE;
+	g_activity = FALSE;
+	UART_setRxCallBack(Provision_receiveCallBack);
+	UART_enableRxInterrupt();
+
+	for(i = 0; i < HASH_SALT_SIZE; i++)
+	{
+		UART_sendByte(header.salt[i]);
+	}
+	UART_sendByte(CREDENTIAL_MAX_RECORDS - next_record);
+
+	while(Provision_waitFrame(frame_index))
+	{
+		frame = g_frames[frame_index];
+		length = g_frameLength[frame_index];
+		count = frame[1];
+
+		AUTH_computeMac(key, frame, length - PROVISION_FRAME_MAC_SIZE, mac);
+		valid = HASH_isEqual(&frame[length - PROVISION_FRAME_MAC_SIZE], mac, PROVISION_FRAME_MAC_SIZE)
+				&& (frame[0] == seq)
+				&& (count <= (CREDENTIAL_MAX_RECORDS - next_record));
+
+		/* The page writes overlap with the reception of the next frame */
+		for(i = 0; valid && (i < count); i++)
+		{
+			valid = (Credential_startRecordWrite(bank, next_record,
+					(const Credential_RecordType *)&frame[PROVISION_FRAME_HEADER_SIZE + (i * CREDENTIAL_RECORD_SIZE)]) == SUCCESS);
+			EEPROM_waitReady();
+			next_record++;
+		}
+
+		if(valid && (count == 0))
+		{
+			/* Commit point: the new bank and its count in one page write */
+			header.count = next_record;
+			header.bank = bank;
+			committed = (Credential_commitHeader(&header) == SUCCESS);
+			valid = committed;
+		}
+
+		if(!valid)
+		{
+			break;
+		}
+
+		/* Free the buffer before the acknowledge, the host reuses it for block seq + 2 */
+		g_frameLength[frame_index] = 0;
+		frame_index ^= 1;
+		UART_sendByte(PROVISION_ACK);
+		UART_sendByte(seq);
+		seq++;
+
+		if(committed)
+		{
+			break;
+		}
+	}
+
+	if(!committed)
+	{
+		UART_sendByte(PROVISION_NAK);
+		UART_sendByte(seq);
+	}
+	Provision_drain();
+	return committed;
+}
+
+static void Provision_receiveCallBack(uint8 data)
+{
+	uint8 *frame;
+
+	g_activity = TRUE;
+	if(g_draining)
+	{
+		return;
+	}
+
+	if(!g_receiving)
+	{
+		if(data == PROVISION_FRAME_START)
+		{
+			if(g_frameLength[g_rxFrame] != 0)
+			{
+				/* The host didn't wait for the acknowledge, no free buffer */
+				g_rxError = TRUE;
+			}
+			else
+			{
+				g_rxIndex = 0;
+				g_rxExpected = PROVISION_FRAME_HEADER_SIZE;
+				g_receiving = TRUE;
+			}
+		}
+		return;
+	}
+
+	frame = g_frames[g_rxFrame];
+	frame[g_rxIndex] = data;
+	g_rxIndex++;
+
+	if(g_rxIndex == PROVISION_FRAME_HEADER_SIZE)
+	{
+		if(data > PROVISION_BLOCK_RECORDS)
+		{
+			g_receiving = FALSE;
+			g_rxError = TRUE;
+			return;
+		}
+		g_rxExpected = PROVISION_FRAME_HEADER_SIZE + (data * CREDENTIAL_RECORD_SIZE) + PROVISION_FRAME_MAC_SIZE;
+	}
+	else if(g_rxIndex == g_rxExpected)
+	{
+		g_frameLength[g_rxFrame] = g_rxIndex;
+		g_rxFrame ^= 1;
+		g_receiving = FALSE;
+	}
+}
+
+static uint8 Provision_waitFrame(uint8 frame_index)
+{
+	uint32 deadline = Tick_deadline(PROVISION_TIMEOUT_MS);
+
+	while(g_frameLength[frame_index] == 0)
+	{
+		if(g_rxError || Tick_isExpired(deadline))
+		{
+			return FALSE;
+		}
+		if(g_activity)
+		{
+			g_activity = FALSE;
+			deadline = Tick_deadline(PROVISION_TIMEOUT_MS);
+		}
+		System_idle(); /* Woken up by the next byte or tick */
+	}
+	return TRUE;
+}
+
+static void Provision_drain(void)
+{
+	g_draining = TRUE;
+	do
+	{
+		g_activity = FALSE;
+		System_waitUntil(Tick_deadline(PROVISION_DRAIN_MS));
+	} while(g_activity);
+	UART_disableRxInterrupt();
+	UART_setRxCallBack(NULL_PTR);
+}
@@ -0,0 +1,67 @@
+ /******************************************************************************
+ *
+ * Module: PROVISION
+ *
+ * File Name: provision.h
+ *
+ * Description: Header file for the bulk credential provisioning over UART
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef PROVISION_H_
+#define PROVISION_H_
+
+#include "std_types.h"
+#include "credential.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Provisioning session, started by the host from the home menu with the door closed:
+ * 1. Host    -> Control : PROVISION_REQUEST, then the login exchange of auth.h with
+ *                         the keypad password
+ * 2. Control -> Host    : site salt (8 bytes) + capacity (number of records, 1 byte)
+ * 3. Host    -> Control : blocks, each one is
+ *                         PROVISION_FRAME_START, seq, n, n records, MAC (8 bytes)
+ *                         the MAC (auth.h) under the session key of the login covers
+ *                         seq, n and the records, n is 0 for the last block
+ * 4. Control -> Host    : PROVISION_ACK + seq once the block is in EEPROM,
+ *                         or PROVISION_NAK + seq and the session is aborted
+ * Records are the EEPROM records (Credential_RecordType), the host computes the
+ * verifiers with the site salt as the HMI does (auth.h). The seq of the first block is 0.
+ *
+ * The host may send block seq + 2 as soon as block seq is acknowledged: one block
+ * is written to EEPROM while the next one is received, so the UART stays busy.
+ * The records go to the bank of the table not in use (credential.h), the
+ * header switching to it is only written once the last block is verified: an
+ * aborted session keeps the previous table.
+ */
+#define PROVISION_REQUEST           'P'
+
+#define PROVISION_FRAME_START       0x7E
+#define PROVISION_ACK               0x06
+#define PROVISION_NAK               0x15
+
+/* Records in one block, 2 blocks are buffered */
+#define PROVISION_BLOCK_RECORDS     8
+
+/* Session aborted if the host stays silent that long */
+#define PROVISION_TIMEOUT_MS        2000
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Run a provisioning session, call it after the login of PROVISION_REQUEST with its
+ * session key. The UART RX interrupt is used during the session and disabled again
+ * at the end. Returns TRUE if the new table was committed.
+ */
+uint8 Provision_run(const uint8 *key);
+
+#endif /* PROVISION_H_ */
@@ -1,15 +1,15 @@
-/*
- * pwm.h
- *
- *  Created on: Nov 5, 2024
- *      Author: hassa
- */
-
-#ifndef PWM_H_
-#define PWM_H_
-#include"std_types.h"
-#include <avr/io.h>
-
-void PWM_Timer0_Start(uint8_t duty_cycle);
-
-#endif /* PWM_H_ */
+/*
+ * pwm.h
+ *
+ *  Created on: Nov 5, 2024
+ *      Author: hassa
+ */
+
+#ifndef PWM_H_
+#define PWM_H_
+#include"std_types.h"
+#include <avr/io.h>
+
+void PWM_Timer0_Start(uint8_t duty_cycle);
+
+#endif /* PWM_H_ */
@@ -0,0 +1,82 @@
+ /******************************************************************************
+ *
+ * Module: RANDOM
+ *
+ * File Name: random.c
+ *
+ * Description: Source file for the entropy pool used to generate salts
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "random.h"
+#include "hash.h"
+#include <avr/io.h> /* To sample the timers counter registers */
+#include <avr/eeprom.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8 g_pool[HASH_SALT_SIZE];
+static uint8 g_poolIndex = 0;
+static uint32 g_outputCounter = 0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void RANDOM_init(void)
+{
+	uint8 seed[HASH_SALT_SIZE];
+	uint8 counter[4] = {0, 0, 0, 0};
+	uint8 i;
+
+	eeprom_read_block(seed, (const void *)RANDOM_SEED_ADDRESS, HASH_SALT_SIZE);
+	for(i = 0; i < HASH_SALT_SIZE; i++)
+	{
+		RANDOM_addEntropy(seed[i]);
+	}
+
+	/*
+	 * Next seed: HASH(pool, counter 0). The outputs use the counters from 1, so
+	 * they don't tell the next seed.
+	 */
+	HASH_compute(g_pool, counter, sizeof(counter), seed);
+	eeprom_update_block(seed, (void *)RANDOM_SEED_ADDRESS, HASH_SALT_SIZE);
+}
+
+void RANDOM_addEntropy(uint8 sample)
+{
+	uint8 index = g_poolIndex;
+
+	/* The counters of all the timers are sampled, whichever of them is running */
+	g_pool[index] = (uint8)((g_pool[index] << 1) | (g_pool[index] >> 7));
+	g_pool[index] ^= sample ^ TCNT0 ^ TCNT1L ^ TCNT2;
+
+	g_poolIndex = (index + 1) % HASH_SALT_SIZE;
+}
+
+void RANDOM_fill(uint8 *buffer, uint8 length)
+{
+	uint8 block[HASH_DIGEST_SIZE];
+	uint8 counter[4];
+	uint8 i;
+
+	while(length > 0)
+	{
+		g_outputCounter++;
+		counter[0] = (uint8)(g_outputCounter);
+		counter[1] = (uint8)(g_outputCounter >> 8);
+		counter[2] = (uint8)(g_outputCounter >> 16);
+		counter[3] = (uint8)(g_outputCounter >> 24);
+
+		/* Whiten the pool: output = HASH(pool, counter) */
+		HASH_compute(g_pool, counter, sizeof(counter), block);
+
+		for(i = 0; (i < HASH_DIGEST_SIZE) && (length > 0); i++, length--)
+		{
+			*buffer++ = block[i];
+		}
+	}
+}
@@ -0,0 +1,56 @@
+ /******************************************************************************
+ *
+ * Module: RANDOM
+ *
+ * File Name: random.h
+ *
+ * Description: Header file for the entropy pool used to generate salts
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Seed of the pool in the internal EEPROM (HASH_SALT_SIZE bytes), just below the
+ * supervisor record. Replaced at every start, so each start draws from a new pool.
+ */
+#define RANDOM_SEED_ADDRESS     0x3F0
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Call it once at start, before the first salt or nonce: mix the seed saved by
+ * the previous start into the pool and save the next one (about 70 ms of EEPROM
+ * writes). Without it the pool starts from the same state at every start and
+ * the first outputs after a reset can be predicted.
+ */
+void RANDOM_init(void);
+
+/*
+ * Description :
+ * Mix a sample and the current value of the running timers into the pool.
+ * Call it on asynchronous events (received bytes, user input) so the timing
+ * jitter between the two ECUs accumulates in the pool.
+ */
+void RANDOM_addEntropy(uint8 sample);
+
+/*
+ * Description :
+ * Fill the buffer with bytes derived from the pool.
+ * Every call uses a new counter value, so two outputs are never the same.
+ */
+void RANDOM_fill(uint8 *buffer, uint8 length);
+
+#endif /* RANDOM_H_ */
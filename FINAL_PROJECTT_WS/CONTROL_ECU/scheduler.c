@@ -0,0 +1,152 @@
+ /******************************************************************************
+ *
+ * Module: SCHEDULER
+ *
+ * File Name: scheduler.c
+ *
+ * Description: Source file for the cooperative run-to-completion task scheduler
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "scheduler.h"
+#include "system.h"
+#include "supervisor.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static Scheduler_TaskType *g_tasks;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Software timer callback, releases the task given as context.
+ */
+static void Scheduler_timerCallBack(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Scheduler_init(void)
+{
+	g_tasks = NULL_PTR;
+}
+
+void Scheduler_add(Scheduler_TaskType *task, uint8 priority,
+		void (*run)(void *context), void *context)
+{
+	Scheduler_TaskType **link = &g_tasks;
+
+	task->run = run;
+	task->context = context;
+	task->priority = priority;
+	task->ready = FALSE;
+	task->supervisor_id = SUPERVISOR_NO_TASK;
+	task->runs = 0;
+	task->total_us = 0;
+	task->max_us = 0;
+	task->timer.next = NULL_PTR;
+	task->timer.prev = NULL_PTR;
+
+	/* After the tasks of the same priority: the list is scanned from the head */
+	while((*link != NULL_PTR) && ((*link)->priority <= priority))
+	{
+		link = &(*link)->next;
+	}
+	task->next = *link;
+	*link = task;
+}
+
+void Scheduler_supervise(Scheduler_TaskType *task, uint16 deadline_ms)
+{
+	task->supervisor_id = Supervisor_register(deadline_ms);
+}
+
+void Scheduler_signal(Scheduler_TaskType *task)
+{
+	/* One byte write, no need to disable the interrupts */
+	task->ready = TRUE;
+}
+
+void Scheduler_signalAfter(Scheduler_TaskType *task, uint32 delay_ms)
+{
+	SwTimer_start(&task->timer, delay_ms, 0, Scheduler_timerCallBack, task);
+}
+
+void Scheduler_setPeriod(Scheduler_TaskType *task, uint32 period_ms)
+{
+	if(period_ms == 0)
+	{
+		SwTimer_cancel(&task->timer);
+	}
+	else
+	{
+		SwTimer_start(&task->timer, period_ms, period_ms, Scheduler_timerCallBack, task);
+	}
+}
+
+uint8 Scheduler_dispatch(void)
+{
+	Scheduler_TaskType *task = g_tasks;
+	uint32 start;
+	uint32 elapsed;
+
+	while((task != NULL_PTR) && !task->ready)
+	{
+		task = task->next;
+	}
+	if(task == NULL_PTR)
+	{
+		return FALSE;
+	}
+
+	/* Cleared before the run, a signal during the run releases the task again */
+	task->ready = FALSE;
+	start = Tick_nowUs();
+	Supervisor_setRunning(task->supervisor_id);
+	task->run(task->context);
+	Supervisor_setRunning(SUPERVISOR_NO_TASK);
+	Supervisor_checkIn(task->supervisor_id);
+	elapsed = Tick_nowUs() - start;
+
+	task->runs++;
+	task->total_us += elapsed;
+	if(elapsed > task->max_us)
+	{
+		task->max_us = elapsed;
+	}
+	return TRUE;
+}
+
+void Scheduler_run(void)
+{
+	Scheduler_TaskType *task;
+
+	while(1)
+	{
+		SwTimer_process();
+		if(!Scheduler_dispatch())
+		{
+			/* No task is waiting to run: none of them is late */
+			for(task = g_tasks; task != NULL_PTR; task = task->next)
+			{
+				Supervisor_checkIn(task->supervisor_id);
+			}
+			/*
+			 * A task signaled by an interrupt after the scan runs after the next
+			 * interrupt at the latest: the tick wakes the CPU up every millisecond.
+			 */
+			System_sleep();
+		}
+	}
+}
+
+static void Scheduler_timerCallBack(void *context)
+{
+	Scheduler_signal((Scheduler_TaskType *)context);
+}
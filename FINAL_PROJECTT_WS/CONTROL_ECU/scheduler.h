@@ -0,0 +1,113 @@
+ /******************************************************************************
+ *
+ * Module: SCHEDULER
+ *
+ * File Name: scheduler.h
+ *
+ * Description: Header file for the cooperative run-to-completion task scheduler
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "std_types.h"
+#include "swtimer.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Priority 0 is the highest, tasks with the same priority run in the order they were added */
+#define SCHEDULER_PRIORITY_HIGHEST      0
+#define SCHEDULER_PRIORITY_LOWEST       255
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * A task is a function that does a bounded amount of work and returns, it never
+ * waits: it keeps its state in static variables and asks to be run again with
+ * Scheduler_signal() (event), Scheduler_signalAfter() (delay) or
+ * Scheduler_setPeriod() (periodic).
+ * The tasks are owned by the application (static variables) like the software
+ * timers. Only use the API to change the fields, the accounting fields can be read.
+ */
+typedef struct Scheduler_TaskType
+{
+	struct Scheduler_TaskType *next;    /* list sorted by priority */
+	void (*run)(void *context);
+	void *context;
+	SwTimer_Type timer;                 /* releases the task for the delays and periods */
+	volatile uint8 ready;               /* set by Scheduler_signal(), also from an ISR */
+	uint8 priority;
+	uint8 supervisor_id;                /* SUPERVISOR_NO_TASK if not supervised */
+
+	/* Run time accounting, in microseconds of the system tick */
+	uint32 runs;
+	uint32 total_us;
+	uint32 max_us;
+}Scheduler_TaskType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Empty the task list, the system services (System_init) must be running.
+ */
+void Scheduler_init(void);
+
+/*
+ * Description :
+ * Add a task, it only runs once it is signaled or given a period.
+ */
+void Scheduler_add(Scheduler_TaskType *task, uint8 priority,
+		void (*run)(void *context), void *context);
+
+/*
+ * Description :
+ * Register the task to the supervisor: a run of the task, or a pass with no task
+ * ready, is a check-in. The task misses its deadline if it is ready for longer
+ * than deadline_ms without running, or if a run of any task takes that long.
+ */
+void Scheduler_supervise(Scheduler_TaskType *task, uint16 deadline_ms);
+
+/*
+ * Description :
+ * Mark the task ready, it runs once even if it is signaled several times before.
+ * Can be called from an interrupt.
+ */
+void Scheduler_signal(Scheduler_TaskType *task);
+
+/*
+ * Description :
+ * Signal the task delay_ms from now, replaces its period or the previous delay.
+ */
+void Scheduler_signalAfter(Scheduler_TaskType *task, uint32 delay_ms);
+
+/*
+ * Description :
+ * Signal the task every period_ms from now, 0 stops the periodic release.
+ */
+void Scheduler_setPeriod(Scheduler_TaskType *task, uint32 period_ms);
+
+/*
+ * Description :
+ * Run the ready task with the highest priority, to completion.
+ * Returns FALSE if no task was ready.
+ */
+uint8 Scheduler_dispatch(void);
+
+/*
+ * Description :
+ * Main loop, never returns: handle the software timers, run the ready tasks by
+ * priority and sleep when none is ready.
+ */
+void Scheduler_run(void);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,119 @@
+ /******************************************************************************
+ *
+ * Module: STORAGE
+ *
+ * File Name: storage.c
+ *
+ * Description: Source file for the storage task (queued EEPROM page writes)
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "storage.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint16 address;
+	uint8 length;
+	uint8 data[EEPROM_PAGE_SIZE];
+}Storage_JobType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static Scheduler_TaskType g_storageTask;
+static Scheduler_TaskType *g_notifyTask;
+
+static Storage_JobType g_jobs[STORAGE_QUEUE_SIZE];
+static uint8 g_head;        /* next job to write */
+static uint8 g_count;       /* queued jobs */
+static uint8 g_writing;     /* TRUE during the write cycle of the last job */
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Storage task: polls the running write cycle or starts the next page write.
+ */
+static void Storage_task(void *context);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Storage_init(uint8 priority, Scheduler_TaskType *notify)
+{
+	g_head = 0;
+	g_count = 0;
+	g_writing = FALSE;
+	g_notifyTask = notify;
+	Scheduler_add(&g_storageTask, priority, Storage_task, NULL_PTR);
+	Scheduler_supervise(&g_storageTask, STORAGE_DEADLINE_MS);
+}
+
+uint8 Storage_writePage(uint16 address, const void *data, uint8 length)
+{
+	Storage_JobType *job;
+	uint8 i;
+
+	if(g_count == STORAGE_QUEUE_SIZE)
+	{
+		return FALSE;
+	}
+
+	job = &g_jobs[(g_head + g_count) % STORAGE_QUEUE_SIZE];
+	job->address = address;
+	job->length = length;
+	for(i = 0; i < length; i++)
+	{
+		job->data[i] = ((const uint8 *)data)[i];
+	}
+	g_count++;
+	Scheduler_signal(&g_storageTask);
+	return TRUE;
+}
+
+uint8 Storage_isIdle(void)
+{
+	return (g_count == 0) && !g_writing;
+}
+
+static void Storage_task(void *context)
+{
+	Storage_JobType *job;
+
+	(void)context;
+
+	if(g_writing)
+	{
+		if(!EEPROM_isReady())
+		{
+			Scheduler_signalAfter(&g_storageTask, STORAGE_POLL_MS);
+			return;
+		}
+		g_writing = FALSE;
+	}
+
+	if(g_count == 0)
+	{
+		if(g_notifyTask != NULL_PTR)
+		{
+			Scheduler_signal(g_notifyTask);
+		}
+		return;
+	}
+
+	/* One page per run, the other tasks run during the write cycle */
+	job = &g_jobs[g_head];
+	EEPROM_writePage(job->address, job->data, job->length);
+	g_head = (g_head + 1) % STORAGE_QUEUE_SIZE;
+	g_count--;
+	g_writing = TRUE;
+	Scheduler_signalAfter(&g_storageTask, STORAGE_POLL_MS);
+}
@@ -0,0 +1,60 @@
+ /******************************************************************************
+ *
+ * Module: STORAGE
+ *
+ * File Name: storage.h
+ *
+ * Description: Header file for the storage task (queued EEPROM page writes)
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef STORAGE_H_
+#define STORAGE_H_
+
+#include "std_types.h"
+#include "external_eeprom.h"
+#include "scheduler.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Page writes waiting for the memory, an enrollment needs 2 (record then header) */
+#define STORAGE_QUEUE_SIZE      4
+
+/* Interval of the acknowledge polls during a write cycle (5 ms at most) */
+#define STORAGE_POLL_MS         1
+
+/* Supervisor deadline of the task: a page transfer over TWI, then short polls */
+#define STORAGE_DEADLINE_MS     200
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Add the storage task to the scheduler. The notify task (may be NULL_PTR) is
+ * signaled every time the queue becomes empty and the memory is ready.
+ */
+void Storage_init(uint8 priority, Scheduler_TaskType *notify);
+
+/*
+ * Description :
+ * Copy up to one page to the queue, it is written by the storage task in the
+ * order of the calls. The data must not cross a page boundary.
+ * Returns FALSE if the queue is full.
+ */
+uint8 Storage_writePage(uint16 address, const void *data, uint8 length);
+
+/*
+ * Description :
+ * Return TRUE when every queued page is written and the memory can be read.
+ * The other tasks must check it before reading the EEPROM: a memory in its
+ * write cycle doesn't answer.
+ */
+uint8 Storage_isIdle(void);
+
+#endif /* STORAGE_H_ */
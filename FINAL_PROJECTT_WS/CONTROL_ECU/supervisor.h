@@ -0,0 +1,116 @@
+ /******************************************************************************
+ *
+ * Module: SUPERVISOR
+ *
+ * File Name: supervisor.h
+ *
+ * Description: Header file for the watchdog supervisor of the tasks
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef SUPERVISOR_H_
+#define SUPERVISOR_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SUPERVISOR_MAX_TASKS        8
+
+/* Returned by Supervisor_register() when the table is full, and "none" in the record */
+#define SUPERVISOR_NO_TASK          0xFF
+
+/*
+ * The check-ins are checked from the Timer1 compare interrupt at this interval, a
+ * deadline is rounded up to it. The watchdog is only reset by that check, so it
+ * also resets the MCU if the interrupts stay disabled.
+ */
+#define SUPERVISOR_CHECK_MS         100
+
+/*
+ * Record of the last supervisor reset in the internal EEPROM, just below the
+ * application record of the bootloader (0x3FC to 0x3FF):
+ * 0x3F8 missed    id of the task that missed its deadline, SUPERVISOR_NO_TASK
+ *                 if the watchdog expired without a check (interrupts disabled)
+ * 0x3F9 running   id of the task that was running then, SUPERVISOR_NO_TASK if none
+ * 0x3FA resets    number of watchdog resets, stops at 255
+ * 0x3FB state     SUPERVISOR_RECORD_LOGGED
+ * Erased EEPROM (0xFF) reads as no reset yet. Read it with the programmer.
+ * The check only keeps the culprit in RAM that the reset doesn't clear, marked
+ * SUPERVISOR_RECORD_PENDING: the record is written by Supervisor_init() after the reset.
+ */
+#define SUPERVISOR_RECORD_ADDRESS   0x3F8
+#define SUPERVISOR_RECORD_PENDING   0x5A
+#define SUPERVISOR_RECORD_LOGGED    0xA5
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint8 missed;
+	uint8 running;
+	uint8 resets;
+	uint8 state;
+}Supervisor_RecordType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Call it first in main(): if the last reset came from the watchdog, write its
+ * record in the internal EEPROM (a few tens of ms), then clear the reset flags.
+ */
+void Supervisor_init(void);
+
+/*
+ * Description :
+ * Register a task that must call Supervisor_checkIn() at least every deadline_ms
+ * (25000 at most) once the supervisor is started. Returns its id (registration
+ * order, it is the id of the record) or SUPERVISOR_NO_TASK if the table is full.
+ */
+uint8 Supervisor_register(uint16 deadline_ms);
+
+/*
+ * Description :
+ * The task is alive: its deadline starts again. One byte write, can be called
+ * from anywhere. SUPERVISOR_NO_TASK is ignored.
+ */
+void Supervisor_checkIn(uint8 id);
+
+/*
+ * Description :
+ * Tell which task runs now (SUPERVISOR_NO_TASK: none), for the record.
+ */
+void Supervisor_setRunning(uint8 id);
+
+/*
+ * Description :
+ * Enable the watchdog and start the check on Timer1, register the tasks before.
+ * When a task misses its deadline its id is kept for the record and the watchdog is
+ * no longer reset: the MCU restarts in the next 15 ms. Global interrupts must be enabled.
+ */
+void Supervisor_start(void);
+
+/*
+ * Description :
+ * Stop checking the deadlines, for a long blocking operation that starves the other
+ * tasks on purpose. The watchdog is still reset by the check, so disabled interrupts
+ * still reset the MCU.
+ */
+void Supervisor_suspend(void);
+
+/*
+ * Description :
+ * Check the deadlines again, they all start again from now.
+ */
+void Supervisor_resume(void);
+
+#endif /* SUPERVISOR_H_ */
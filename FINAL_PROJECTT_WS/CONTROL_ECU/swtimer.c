@@ -0,0 +1,179 @@
+ /******************************************************************************
+ *
+ * Module: SWTIMER
+ *
+ * File Name: swtimer.c
+ *
+ * Description: Source file for the software timers (hashed timing wheel on the system tick)
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "swtimer.h"
+#include "tick.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+#define SWTIMER_SLOT(tick)          ((uint8)(tick) & (SWTIMER_WHEEL_SIZE - 1))
+
+/* One bit per slot: set while the slot list is not empty */
+#define SWTIMER_MARK(slot)          (g_occupied[(slot) >> 3] |= (uint8)(1 << ((slot) & 7)))
+#define SWTIMER_UNMARK(slot)        (g_occupied[(slot) >> 3] &= (uint8)~(1 << ((slot) & 7)))
+#define SWTIMER_IS_MARKED(slot)     (g_occupied[(slot) >> 3] & (uint8)(1 << ((slot) & 7)))
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static SwTimer_Type *g_slots[SWTIMER_WHEEL_SIZE];
+static uint8 g_occupied[SWTIMER_WHEEL_SIZE / 8];
+
+/* Last tick handled by SwTimer_process() */
+static uint32 g_processed;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void SwTimer_link(SwTimer_Type *timer);
+static void SwTimer_unlink(SwTimer_Type *timer);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void SwTimer_init(void)
+{
+	uint8 i;
+
+	for(i = 0; i < SWTIMER_WHEEL_SIZE; i++)
+	{
+		g_slots[i] = NULL_PTR;
+	}
+	for(i = 0; i < (SWTIMER_WHEEL_SIZE / 8); i++)
+	{
+		g_occupied[i] = 0;
+	}
+	g_processed = Tick_now();
+}
+
+void SwTimer_start(SwTimer_Type *timer, uint32 delay_ms, uint32 period_ms,
+		void (*callback)(void *context), void *context)
+{
+	SwTimer_cancel(timer);
+
+	/* At least one tick, a timer can't expire in a tick that is already handled */
+	if(delay_ms == 0)
+	{
+		delay_ms = 1;
+	}
+	timer->expiry = Tick_now() + delay_ms;
+	timer->period = period_ms;
+	timer->callback = callback;
+	timer->context = context;
+	SwTimer_link(timer);
+}
+
+void SwTimer_cancel(SwTimer_Type *timer)
+{
+	if(SwTimer_isRunning(timer))
+	{
+		SwTimer_unlink(timer);
+	}
+}
+
+uint8 SwTimer_isRunning(const SwTimer_Type *timer)
+{
+	/* A linked timer always has a previous node: the slot head points back to itself */
+	return (timer->prev != NULL_PTR);
+}
+
+void SwTimer_process(void)
+{
+	uint32 now = Tick_now();
+	SwTimer_Type *timer;
+	uint8 slot;
+
+	while(g_processed != now)
+	{
+		g_processed++;
+		slot = SWTIMER_SLOT(g_processed);
+		if(!SWTIMER_IS_MARKED(slot))
+		{
+			continue;
+		}
+
+		timer = g_slots[slot];
+		while(timer != NULL_PTR)
+		{
+			if(timer->expiry != g_processed)
+			{
+				/* Expires in a later turn of the wheel */
+				timer = timer->next;
+				continue;
+			}
+
+			SwTimer_unlink(timer);
+			if(timer->period != 0)
+			{
+				timer->expiry += timer->period;
+				if((sint32)(timer->expiry - g_processed) <= 0)
+				{
+					/* Late processing, don't wait for the next turn of the wheel */
+					timer->expiry = g_processed + 1;
+				}
+				SwTimer_link(timer);
+			}
+			timer->callback(timer->context);
+
+			/*
+			 * The callback may cancel or restart any timer, so the scan starts again
+			 * from the head: the timers already called are unlinked or in a later turn
+			 */
+			timer = g_slots[slot];
+		}
+	}
+}
+
+static void SwTimer_link(SwTimer_Type *timer)
+{
+	uint8 slot = SWTIMER_SLOT(timer->expiry);
+
+	timer->next = g_slots[slot];
+	if(timer->next != NULL_PTR)
+	{
+		timer->next->prev = timer;
+	}
+	/* The head has no previous timer, it points to itself to mark it as linked */
+	timer->prev = timer;
+	g_slots[slot] = timer;
+	SWTIMER_MARK(slot);
+}
+
+static void SwTimer_unlink(SwTimer_Type *timer)
+{
+	uint8 slot = SWTIMER_SLOT(timer->expiry);
+
+	if(timer->prev == timer)
+	{
+		g_slots[slot] = timer->next;
+	}
+	else
+	{
+		timer->prev->next = timer->next;
+	}
+
+	if(timer->next != NULL_PTR)
+	{
+		timer->next->prev = (timer->prev == timer) ? timer->next : timer->prev;
+	}
+
+	if(g_slots[slot] == NULL_PTR)
+	{
+		SWTIMER_UNMARK(slot);
+	}
+	timer->next = NULL_PTR;
+	timer->prev = NULL_PTR;
+}
@@ -0,0 +1,51 @@
+ /******************************************************************************
+ *
+ * Module: SYSTEM
+ *
+ * File Name: system.h
+ *
+ * Description: Header file for the system services: time base, software timers and idle sleep
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef SYSTEM_H_
+#define SYSTEM_H_
+
+#include "std_types.h"
+#include "tick.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start the millisecond tick, empty the software timer wheel and select the
+ * idle sleep mode. Global interrupts must be enabled.
+ */
+void System_init(void);
+
+/*
+ * Description :
+ * Stop the CPU until the next interrupt (SLEEP_MODE_IDLE: the timers, UART and
+ * TWI keep running). The tick interrupt wakes it up at least every millisecond.
+ */
+void System_sleep(void);
+
+/*
+ * Description :
+ * One pass of the idle loop: run the expired software timers then sleep.
+ */
+void System_idle(void);
+
+/*
+ * Description :
+ * Wait in the idle loop until the deadline (from Tick_deadline()) is reached.
+ * The comparison is correct across the tick wrap, and a deadline that is
+ * already reached returns at once.
+ */
+void System_waitUntil(uint32 deadline);
+
+#endif /* SYSTEM_H_ */
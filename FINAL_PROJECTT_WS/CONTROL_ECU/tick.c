@@ -0,0 +1,109 @@
+ /******************************************************************************
+ *
+ * Module: TICK
+ *
+ * File Name: tick.c
+ *
+ * Description: Source file for the monotonic millisecond system tick
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "tick.h"
+#include "timer.h"
+#include "timer_cfg.h"
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Microseconds per count of the tick timer, folded by the compiler */
+#define TICK_US_PER_COUNT \
+	((TICK_PERIOD_MS * 1000UL) / (TIMER_COMPARE_VALUE(TIMER2_ID, TICK_PERIOD_MS * 1000UL) + 1))
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+volatile uint32 g_ticks = 0;
+
+static const Timer_ConfigType g_tickTimerConfig = TIMER_CTC_CONFIG(TIMER2_ID, TICK_PERIOD_MS * 1000UL);
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+#ifndef TIMER2_COMP_STATIC_HANDLER
+/*
+ * Timer2 compare match callback, only used when the vector is not bound in timer_cfg.h.
+ */
+static void Tick_callBack(void);
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Tick_init(void)
+{
+	g_ticks = 0;
+#ifndef TIMER2_COMP_STATIC_HANDLER
+	Timer_setCallBack(Tick_callBack, TIMER2_ID);
+#endif
+	Timer_init(&g_tickTimerConfig);
+}
+
+uint32 Tick_now(void)
+{
+	uint8 sreg = SREG;
+	uint32 ticks;
+
+	/* The 4 bytes must be read without a tick in between */
+	SREG &= ~(1 << 7);
+	ticks = g_ticks;
+	SREG = sreg;
+	return ticks;
+}
+
+uint32 Tick_nowUs(void)
+{
+	uint8 sreg = SREG;
+	uint32 ticks;
+	uint8 count;
+
+	SREG &= ~(1 << 7);
+	ticks = g_ticks;
+	count = TCNT2;
+	/* The compare match happened but its interrupt is still pending */
+	if((TIFR & (1 << OCF2)) && (count < (g_tickTimerConfig.timer_compare_MatchValue / 2)))
+	{
+		ticks++;
+	}
+	SREG = sreg;
+
+	return (ticks * (TICK_PERIOD_MS * 1000UL)) + ((uint32)count * TICK_US_PER_COUNT);
+}
+
+uint32 Tick_elapsed(uint32 start)
+{
+	return Tick_now() - start;
+}
+
+uint32 Tick_deadline(uint32 duration_ms)
+{
+	return Tick_now() + duration_ms;
+}
+
+uint8 Tick_isExpired(uint32 deadline)
+{
+	/* Signed difference, correct across the counter wrap */
+	return ((sint32)(Tick_now() - deadline) >= 0);
+}
+
+#ifndef TIMER2_COMP_STATIC_HANDLER
+static void Tick_callBack(void)
+{
+	Tick_handler();
+}
+#endif
@@ -0,0 +1,94 @@
+ /******************************************************************************
+ *
+ * Module: TICK
+ *
+ * File Name: tick.h
+ *
+ * Description: Header file for the monotonic millisecond system tick
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef TICK_H_
+#define TICK_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Timer2 is reserved for the tick in both ECUs (Timer0 drives the motor PWM of the
+ * control ECU and the keypad scan of the HMI, Timer1 is the supervisor check, or
+ * the cycle counter of the benchmark firmware).
+ * The counter wraps after 49.7 days, the helpers below stay correct across the
+ * wrap as long as a duration is shorter than half of it.
+ */
+#define TICK_PERIOD_MS          1
+
+/* Convert a duration in seconds (configuration values) to ticks */
+#define TICK_SECONDS(seconds)   ((uint32)(seconds) * (1000UL / TICK_PERIOD_MS))
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Only written by Tick_handler(), read it with Tick_now() */
+extern volatile uint32 g_ticks;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start Timer2 in CTC mode with one interrupt per millisecond, it is never stopped.
+ * Global interrupts must be enabled.
+ */
+void Tick_init(void);
+
+/*
+ * Description :
+ * Return the number of milliseconds since Tick_init().
+ */
+uint32 Tick_now(void);
+
+/*
+ * Description :
+ * Return the time since Tick_init() in microseconds, with the resolution of the
+ * Timer2 count (4 us). Wraps after 71 minutes: only use it for short durations.
+ */
+uint32 Tick_nowUs(void);
+
+/*
+ * Description :
+ * Return the number of milliseconds since the given Tick_now() value.
+ */
+uint32 Tick_elapsed(uint32 start);
+
+/*
+ * Description :
+ * Return the deadline duration_ms from now, to be checked with Tick_isExpired().
+ */
+uint32 Tick_deadline(uint32 duration_ms);
+
+/*
+ * Description :
+ * Return TRUE once the deadline is reached.
+ */
+uint8 Tick_isExpired(uint32 deadline);
+
+/*
+ * Description :
+ * Count one tick, the body of the Timer2 compare match interrupt.
+ * Always inlined (the application is built with -O0) so the vector bound to it
+ * in timer_cfg.h has no call overhead.
+ */
+static inline __attribute__((always_inline)) void Tick_handler(void)
+{
+	g_ticks++;
+}
+
+#endif /* TICK_H_ */
@@ -1,64 +1,132 @@
-/*
- * timer.h
- *
- *  Created on: Nov 7, 2024
- *      Author: hassan
- */
-
-#ifndef TIMER_H_
-#define TIMER_H_
-
-
-#include "std_types.h"
-
-/*******************************************************************************
- *                               Types Declaration                             *
- *******************************************************************************/
-typedef enum
-{
-	TIMER0_ID , TIMER1_ID , TIMER2_ID
-}Timer_ID_Type;
-
-typedef enum
-{
-	TIMER0_1_PRESCALER_NONE =	0,
-	TIMER0_1_PRESCALER_1 = 		1,
-	TIMER0_1_PRESCALER_8  = 	2,
-	TIMER0_1_PRESCALER_64  = 	3,
-	TIMER0_1_PRESCALER_256  =   4,
-	TIMER0_1_PRESCALER_1024 = 	5,
-	TIMER0_1_EXTERNAL_FALLING = 6,
-	TIMER0_1_EXTERNAL_RAISING = 7,
-
-	TIMER2_PRESCALER_NONE = 	0,
-	TIMER2_PRESCALER_1 = 		1,
-	TIMER2_PRESCALER_8 = 		2,
-	TIMER2_PRESCALER_32 = 		3,
-	TIMER2_PRESCALER_64 = 		4,
-	TIMER2_PRESCALER_128 = 		5,
-	TIMER2_PRESCALER_256 = 		6,
-	TIMER2_PRESCALER_1024 = 	7
-}Timer_ClockType;
-
-typedef enum
-{
-	NORMAL_MODE = 0 , CTC_MODE = 1
-}Timer_ModeType;
-
-typedef struct
-{
-	uint16 timer_InitialValue;
-	uint16 timer_compare_MatchValue;     /*it will be used in compare mode only*/
-	Timer_ID_Type  timer_ID;
-	Timer_ClockType timer_clock;
-	Timer_ModeType  timer_mode;
-}Timer_ConfigType;
-
-/*******************************************************************************
- *                              Functions Prototypes                           *
- *******************************************************************************/
-void Timer_init(const Timer_ConfigType * Config_Ptr);
-void Timer_deInit(Timer_ID_Type timer_type);
-void Timer_setCallBack(void(*a_ptr)(void), Timer_ID_Type a_timer_ID );
-
-#endif /* TIMER_H_ */
+/*
+ * timer.h
+ *
+ *  Created on: Nov 7, 2024
+ *      Author: hassan
+ */
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum
+{
+	TIMER0_ID , TIMER1_ID , TIMER2_ID
+}Timer_ID_Type;
+
+typedef enum
+{
+	TIMER0_1_PRESCALER_NONE =	0,
+	TIMER0_1_PRESCALER_1 = 		1,
+	TIMER0_1_PRESCALER_8  = 	2,
+	TIMER0_1_PRESCALER_64  = 	3,
+	TIMER0_1_PRESCALER_256  =   4,
+	TIMER0_1_PRESCALER_1024 = 	5,
+	TIMER0_1_EXTERNAL_FALLING = 6,
+	TIMER0_1_EXTERNAL_RAISING = 7,
+
+	TIMER2_PRESCALER_NONE = 	0,
+	TIMER2_PRESCALER_1 = 		1,
+	TIMER2_PRESCALER_8 = 		2,
+	TIMER2_PRESCALER_32 = 		3,
+	TIMER2_PRESCALER_64 = 		4,
+	TIMER2_PRESCALER_128 = 		5,
+	TIMER2_PRESCALER_256 = 		6,
+	TIMER2_PRESCALER_1024 = 	7
+}Timer_ClockType;
+
+typedef enum
+{
+	NORMAL_MODE = 0 , CTC_MODE = 1
+}Timer_ModeType;
+
+typedef struct
+{
+	uint16 timer_InitialValue;
+	uint16 timer_compare_MatchValue;     /*it will be used in compare mode only*/
+	Timer_ID_Type  timer_ID;
+	Timer_ClockType timer_clock;
+	Timer_ModeType  timer_mode;
+}Timer_ConfigType;
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/*
+ * Compile-time configuration of a CTC timer from its period in microseconds:
+ *     static const Timer_ConfigType config = TIMER_CTC_CONFIG(TIMER2_ID, 1000);
+ * The smallest prescaler that fits the counter is chosen (best resolution) and the
+ * compare value is computed from F_CPU, so changing F_CPU keeps every period.
+ * A period the timer can't produce (e.g. 1 s on an 8-bit timer) fails the build
+ * with "size of unnamed array is negative".
+ */
+#define TIMER_CTC_CONFIG(id, period_us) \
+	{0, (uint16)(TIMER_COMPARE_VALUE(id, period_us) + TIMER_PERIOD_CHECK(id, period_us)), \
+	(id), TIMER_CLOCK(id, period_us), CTC_MODE}
+
+/* Timer counts for a period with a prescaler, folded by the compiler */
+#define TIMER_COUNTS(period_us, prescaler) \
+	(((unsigned long long)F_CPU * (period_us)) / (1000000ULL * (prescaler)))
+
+#define TIMER_MAX_COUNTS(id)            (((id) == TIMER1_ID) ? 65536ULL : 256ULL)
+
+#define TIMER_FITS(id, period_us, prescaler) \
+	((TIMER_COUNTS(period_us, prescaler) >= 1) && (TIMER_COUNTS(period_us, prescaler) <= TIMER_MAX_COUNTS(id)))
+
+/* Prescaler division chosen for the period, 0 if none fits (32 and 128 exist on Timer2 only) */
+#define TIMER_PRESCALER(id, period_us) \
+	(TIMER_FITS(id, period_us, 1) ? 1 : \
+	TIMER_FITS(id, period_us, 8) ? 8 : \
+	(((id) == TIMER2_ID) && TIMER_FITS(id, period_us, 32)) ? 32 : \
+	TIMER_FITS(id, period_us, 64) ? 64 : \
+	(((id) == TIMER2_ID) && TIMER_FITS(id, period_us, 128)) ? 128 : \
+	TIMER_FITS(id, period_us, 256) ? 256 : \
+	TIMER_FITS(id, period_us, 1024) ? 1024 : 0)
+
+/* The timer counts from 0 to the compare value included */
+#define TIMER_COMPARE_VALUE(id, period_us) \
+	(TIMER_COUNTS(period_us, TIMER_PRESCALER(id, period_us)) - 1)
+
+/* Clock select value of the chosen prescaler */
+#define TIMER_CLOCK(id, period_us) \
+	(((id) == TIMER2_ID) ? TIMER2_CLOCK_OF(TIMER_PRESCALER(id, period_us)) \
+	: TIMER0_1_CLOCK_OF(TIMER_PRESCALER(id, period_us)))
+
+#define TIMER0_1_CLOCK_OF(prescaler) \
+	(((prescaler) == 1) ? TIMER0_1_PRESCALER_1 : \
+	((prescaler) == 8) ? TIMER0_1_PRESCALER_8 : \
+	((prescaler) == 64) ? TIMER0_1_PRESCALER_64 : \
+	((prescaler) == 256) ? TIMER0_1_PRESCALER_256 : TIMER0_1_PRESCALER_1024)
+
+#define TIMER2_CLOCK_OF(prescaler) \
+	(((prescaler) == 1) ? TIMER2_PRESCALER_1 : \
+	((prescaler) == 8) ? TIMER2_PRESCALER_8 : \
+	((prescaler) == 32) ? TIMER2_PRESCALER_32 : \
+	((prescaler) == 64) ? TIMER2_PRESCALER_64 : \
+	((prescaler) == 128) ? TIMER2_PRESCALER_128 : \
+	((prescaler) == 256) ? TIMER2_PRESCALER_256 : TIMER2_PRESCALER_1024)
+
+/* Adds 0, or breaks the build if no prescaler fits */
+#define TIMER_PERIOD_CHECK(id, period_us) \
+	(0 * sizeof(char[(TIMER_PRESCALER(id, period_us) != 0) ? 1 : -1]))
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+void Timer_init(const Timer_ConfigType * Config_Ptr);
+void Timer_deInit(Timer_ID_Type timer_type);
+
+/*
+ * Description :
+ * Set the function called by the interrupts of the timer. It has no effect on a
+ * vector bound at compile time in timer_cfg.h.
+ */
+void Timer_setCallBack(void(*a_ptr)(void), Timer_ID_Type a_timer_ID );
+
+#endif /* TIMER_H_ */
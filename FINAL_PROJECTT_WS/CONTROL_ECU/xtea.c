@@ -0,0 +1,98 @@
+ /******************************************************************************
+ *
+ * Module: XTEA
+ *
+ * File Name: xtea.c
+ *
+ * Description: Source file for the XTEA block cipher
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "xtea.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+#define XTEA_DELTA      0x9E3779B9UL
+#define XTEA_CYCLES     32
+#define XTEA_SUM_END    0xC6EF3720UL /* XTEA_DELTA * XTEA_CYCLES modulo 2^32 */
+
+/* Big endian load/store of a 32-bit word */
+#define XTEA_LOAD32(p) (((uint32)((p)[0]) << 24) | ((uint32)((p)[1]) << 16) | \
+		((uint32)((p)[2]) << 8) | ((uint32)((p)[3])))
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Load the key words, the key schedule of XTEA is only an index in this array.
+ */
+static void XTEA_loadKey(const uint8 *key, uint32 *k);
+
+/*
+ * Store a 32-bit word in big endian order.
+ */
+static void XTEA_store32(uint8 *p, uint32 value);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void XTEA_encrypt(const uint8 *key, uint8 *block)
+{
+	uint32 k[4];
+	uint32 v0 = XTEA_LOAD32(block);
+	uint32 v1 = XTEA_LOAD32(block + 4);
+	uint32 sum = 0;
+	uint8 i;
+
+	XTEA_loadKey(key, k);
+	for(i = 0; i < XTEA_CYCLES; i++)
+	{
+		v0 += (((v1 << 4) ^ (v1 >> 5)) + v1) ^ (sum + k[(uint8)sum & 3]);
+		sum += XTEA_DELTA;
+		v1 += (((v0 << 4) ^ (v0 >> 5)) + v0) ^ (sum + k[(uint8)(sum >> 11) & 3]);
+	}
+	XTEA_store32(block, v0);
+	XTEA_store32(block + 4, v1);
+}
+
+void XTEA_decrypt(const uint8 *key, uint8 *block)
+{
+	uint32 k[4];
+	uint32 v0 = XTEA_LOAD32(block);
+	uint32 v1 = XTEA_LOAD32(block + 4);
+	uint32 sum = XTEA_SUM_END;
+	uint8 i;
+
+	XTEA_loadKey(key, k);
+	for(i = 0; i < XTEA_CYCLES; i++)
+	{
+		v1 -= (((v0 << 4) ^ (v0 >> 5)) + v0) ^ (sum + k[(uint8)(sum >> 11) & 3]);
+		sum -= XTEA_DELTA;
+		v0 -= (((v1 << 4) ^ (v1 >> 5)) + v1) ^ (sum + k[(uint8)sum & 3]);
+	}
+	XTEA_store32(block, v0);
+	XTEA_store32(block + 4, v1);
+}
+
+static void XTEA_loadKey(const uint8 *key, uint32 *k)
+{
+	uint8 i;
+
+	for(i = 0; i < 4; i++)
+	{
+		k[i] = XTEA_LOAD32(key + 4 * i);
+	}
+}
+
+static void XTEA_store32(uint8 *p, uint32 value)
+{
+	p[0] = (uint8)(value >> 24);
+	p[1] = (uint8)(value >> 16);
+	p[2] = (uint8)(value >> 8);
+	p[3] = (uint8)(value);
+}
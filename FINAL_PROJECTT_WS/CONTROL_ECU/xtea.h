@@ -0,0 +1,41 @@
+ /******************************************************************************
+ *
+ * Module: XTEA
+ *
+ * File Name: xtea.h
+ *
+ * Description: Header file for the XTEA block cipher
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef XTEA_H_
+#define XTEA_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+#define XTEA_BLOCK_SIZE     8
+#define XTEA_KEY_SIZE       16
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Encrypt one 8 bytes block in place with a 16 bytes key (32 cycles).
+ * Words are loaded big endian so the results match the usual XTEA test vectors.
+ */
+void XTEA_encrypt(const uint8 *key, uint8 *block);
+
+/*
+ * Description :
+ * Decrypt one 8 bytes block in place with a 16 bytes key.
+ */
+void XTEA_decrypt(const uint8 *key, uint8 *block);
+
+#endif /* XTEA_H_ */
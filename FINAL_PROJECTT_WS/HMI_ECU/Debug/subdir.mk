@@ -5,30 +5,69 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../HMI_ECU_main.c \
+../auth.c \
+../bench.c \
+../config.c \
+../crc.c \
+../event_queue.c \
 ../gpio.c \
+../hash.c \
 ../keypad.c \
 ../lcd.c \
+../lcd_fb.c \
 ../pwm.c \
+../screen.c \
+../supervisor.c \
+../swtimer.c \
+../system.c \
+../tick.c \
 ../timer.c \
-../uart.c 
+../uart.c \
+../xtea.c 
 
 OBJS += \
 ./HMI_ECU_main.o \
+./auth.o \
+./bench.o \
+./config.o \
+./crc.o \
+./event_queue.o \
 ./gpio.o \
+./hash.o \
 ./keypad.o \
 ./lcd.o \
+./lcd_fb.o \
 ./pwm.o \
+./screen.o \
+./supervisor.o \
+./swtimer.o \
+./system.o \
+./tick.o \
 ./timer.o \
-./uart.o 
+./uart.o \
+./xtea.o 
 
 C_DEPS += \
 ./HMI_ECU_main.d \
+./auth.d \
+./bench.d \
+./config.d \
+./crc.d \
+./event_queue.d \
 ./gpio.d \
+./hash.d \
 ./keypad.d \
 ./lcd.d \
+./lcd_fb.d \
 ./pwm.d \
+./screen.d \
+./supervisor.d \
+./swtimer.d \
+./system.d \
+./tick.d \
 ./timer.d \
-./uart.d 
+./uart.d \
+./xtea.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -1,318 +1,691 @@
-/*
- * HMI_ECU_main.c
- *
- * Created on: Nov 5, 2024
- * Author: hassa
- *
- * Description:
- * This is the main file for the HMI (Human-Machine Interface) ECU. It manages
- * password input, authentication, and door control interactions with the control ECU
- * over UART. The system includes functionalities for setting a new password, logging in,
- * opening the door, and changing the password, with protection against unauthorized access.
- */
-
-#include "lcd.h"
-#include "keypad.h"
-#include "uart.h"
-#include "timer.h"
-#include "std_types.h"
-#include <util/delay.h>
-#include <avr/io.h>
-#include <avr/interrupt.h>
-
-/*******************************************************************************
- *                          Global Variables                                   *
- *******************************************************************************/
-uint8 match = 0;         // Flag to store password setup confirmation from control ECU
-uint8 match2 = 0;        // Flag to store login status from control ECU
-uint8 match3 = 0;        // Flag for additional control messages
-uint8 g_count = 0;       // Counter for time-based operations
-uint8 try_count = 0;     // Counter for tracking failed login attempts
-uint8 key;
-
-UART_ConfigType config = {eight, EVEN, ONE_BIT, 9600};
-Timer_ConfigType configurate = {0, 31250, TIMER1_ID, TIMER0_1_PRESCALER_256, CTC_MODE};
-
-/*******************************************************************************
- *                          Function Definitions                               *
- *******************************************************************************/
-
-/*
- * Description:
- * Timer callback function increments g_count to track elapsed time.
- */
-void timer_CallBack() {
-	g_count++;
-}
-/*
- * Description:
- * Flushes the UART receive buffer to prevent any leftover bytes from interfering with operations.
- */
-void UART_flushBuffer(void)
-{
-	while (UCSRA & (1 << RXC)) {
-		(void)UDR;  // Read and discard the byte in the receive buffer
-	}
-}
-
-/*
- * Description:
- * Sends a 5-digit password over UART to the control ECU.
- */
-void send_password_to_control_ECU(uint8* password) {
-	for (uint8 i = 0; i < 5; i++) {
-		UART_sendByte(password[i]);
-		_delay_ms(10);
-	}
-}
-
-/*
- * Description:
- * Clears the provided password array by setting each element to 0.
- */
-void clear_password_input(uint8* password) {
-	for (uint8 i = 0; i < 5; i++) {
-		password[i] = 0;
-	}
-}
-
-/*
- * Description:
- * Handles user input from the keypad, storing a 5-digit password
- * and displaying '*' for each digit entered on the LCD.
- */
-void handle_password_input(uint8* password) {
-	uint8 key = 0;
-	uint8 pass_counter = 0;
-
-	// Loop until a 5-digit password is entered
-	while (pass_counter < 5) {
-		key = KEYPAD_getPressedKey();
-		_delay_ms(10);
-		while (!(key >= 0 && key <= 16)) {
-			key = KEYPAD_getPressedKey();
-			_delay_ms(10);
-		}
-		_delay_ms(300);
-		password[pass_counter] = key;
-		LCD_displayCharacter('*');
-		pass_counter++;
-	}
-
-	// Wait until the user confirms input with '='
-	while (key != '=') {
-		key = KEYPAD_getPressedKey();
-	}
-}
-
-/*
- * Description:
- * Initiates the process of setting a new password and confirms with the control ECU.
- */
-void new_password(void) {
-	uint8 password[5] = {0};
-	uint8 re_entered[5] = {0};
-	match = 0;
-
-	// Prompt for the initial password input
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0, 0, "Plz Enter Pass:");
-	LCD_moveCursor(1, 0);
-	handle_password_input(password);
-	send_password_to_control_ECU(password);
-
-	// Prompt to re-enter the password for confirmation
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0, 0, "Plz re-Enter the");
-	LCD_displayStringRowColumn(1, 0, "same pass:");
-	LCD_moveCursor(1, 10);
-	handle_password_input(re_entered);
-	send_password_to_control_ECU(re_entered);
-
-	// Receive confirmation from control ECU for password match
-	while (!match) {
-		match = UART_recieveByte();
-		if (match2 == 0) break;
-	}
-	clear_password_input(password);
-}
-
-/*
- * Description:
- * Initiates the login process by requesting password entry and confirming with control ECU.
- */
-void login_password(void) {
-	uint8 password[5] = {0};
-	match2 = 0;
-
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0, 0, "Please Enter old");
-	LCD_displayStringRowColumn(1, 0, "Pass:");
-	LCD_moveCursor(1, 5);
-
-	handle_password_input(password);
-	send_password_to_control_ECU(password);
-
-	// Clear any remaining data in the UART buffer
-	UART_flushBuffer();
-
-	// Wait for the response from control ECU
-	while (!match2) {
-		match2 = UART_recieveByte();
-		if (match2 == 0) break;  // Exit if the password is incorrect
-	}
-	clear_password_input(password);
-}
-
-/*
- * Description:
- * Displays the home page options on the LCD for opening the door or changing the password.
- */
-void Home_page_display(void) {
-	LCD_clearScreen();
-	LCD_displayStringRowColumn(0, 0, "+ : OPEN DOOR");
-	LCD_displayStringRowColumn(1, 0, "- : CHANGE PASS");
-}
-
-/*
- * Description:
- * Resets the flag variables and counters to initial states.
- */
-void reset_flags() {
-	match = 0;
-	match2 = 0;
-	match3 = 0;
-	try_count = 0;
-	g_count = 0;
-}
-
-/*******************************************************************************
- *                          Main Function                                      *
- *******************************************************************************/
-int main(void)
-{
-	reset_flags();
-	uint8 pir_receive = 0;  // Variable to store PIR sensor status from control ECU
-	SREG |= (1 << 7);       // Enable global interrupts
-	UART_init(&config);     // Initialize UART with configured parameters
-	LCD_init();             // Initialize LCD
-	Timer_init(&configurate);   // Initialize timer with configured parameters
-	Timer_setCallBack(timer_CallBack, TIMER1_ID);   // Set timer callback function
-
-	/* Password Setup Phase */
-	while (match != 1) {
-		// Wait for confirmation of successful password setup
-		new_password();
-		_delay_ms(100);
-	}
-
-	/* Main Control Loop */
-	while (1) {
-		LCD_clearScreen();
-		Home_page_display();
-		key = 0;
-		reset_flags();
-
-		while (key != '+' && key != '-') {
-			key = KEYPAD_getPressedKey();
-		}
-
-		/* Main Option Selection */
-		switch (key) {
-		case '+':  // Door Open Sequence
-			UART_sendByte('+');
-			match2 = 0;
-			key = 0;
-
-			while ((match2 == 0) && (try_count < 3))
-			{
-				login_password();
-				if (match2 == 0) {
-					match2 = 1;
-					match3 = UART_recieveByte();
-					if (match3 == 0) {
-						try_count++;
-						match2=0;
-					} else if (match3 == 'L') {
-						match2 = 1;
-						match3 = 0;
-					}
-					if (try_count == 3)
-					{
-						LCD_clearScreen();
-						LCD_displayStringRowColumn(0, 0, "System LOCKED");
-						LCD_displayStringRowColumn(1, 0, "Wait for 1 min");
-						g_count = 0;
-						while (g_count < 60) {};
-						try_count = 0;
-						reset_flags();
-						break;
-					}
-				}
-			}
-
-			g_count = 0;
-			LCD_clearScreen();
-			LCD_displayStringRowColumn(0, 0, "Door Unlocking");
-			LCD_displayStringRowColumn(1, 0, "Please wait   ");
-			while (g_count != 15) {};
-
-			pir_receive = UART_recieveByte();
-			if (pir_receive) {
-				LCD_clearScreen();
-				LCD_displayStringRowColumn(0, 0, "Wait for people");
-				LCD_displayStringRowColumn(1, 0, "to enter");
-				while (pir_receive) {
-					pir_receive = UART_recieveByte();
-				};
-			}
-
-			if (pir_receive == 0) {
-				g_count = 0;
-				LCD_clearScreen();
-				LCD_displayStringRowColumn(0, 0, "Door Locking");
-				LCD_displayStringRowColumn(1, 0, "Please wait   ");
-				while (g_count != 15) {};
-			}
-
-			try_count = 0;
-			match2 = 0;
-			break;
-
-		case '-':  // Change Password Sequence
-			UART_sendByte('-');
-			reset_flags();
-
-			while ((match2 == 0) && (try_count < 3))
-			{
-				login_password();
-				if (match2 == 0) {
-					match2 = 1;
-					match3 = UART_recieveByte();
-					if (match3 == 0) {
-						try_count++;
-						match2=0;
-					} else if (match3 == 'L') {
-						match2 = 1;
-						match3 = 0;
-					}
-					if (try_count == 3)
-					{
-						LCD_clearScreen();
-						LCD_displayStringRowColumn(0, 0, "System LOCKED");
-						LCD_displayStringRowColumn(1, 0, "Wait for 1 min");
-						g_count = 0;
-						while (g_count < 60) {};
-						try_count = 0;
-						reset_flags();
-						break;
-					}
-				}
-			}
-
-			g_count = 0;
-			new_password();
-			break;
-		}
-	}
-}
+/*
+ * HMI_ECU_main.c
+ *
+ * Created on: Nov 5, 2024
+ * Author: hassa
+ *
+ * Description:
+ * This is the main file for the HMI (Human-Machine Interface) ECU. It manages
+ * password input, authentication, and door control interactions with the control ECU
+ * over UART. The system includes functionalities for setting a new password, logging in,
+ * opening the door, and changing the password, with protection against unauthorized access.
+ *
+ * Every flow is a protothread (pt.h): it reads as sequential code but returns at each
+ * wait, so one loop drives the screens and the link together. The keypad is scanned
+ * and debounced by the Timer0 interrupt, which hands the key presses to the flows.
+ * The flows draw the screens from the templates of screen.c in the framebuffer
+ * (lcd_fb.h) and go on, the same interrupt sends the cells that changed to the LCD
+ * in the background.
+ */
+
+#include "lcd.h"
+#include "lcd_fb.h"
+#include "screen.h"
+#include "keypad.h"
+#include "timer.h"
+#include "uart.h"
+#include "system.h"
+#include "pt.h"
+#include "event_queue.h"
+#include "supervisor.h"
+#include "auth.h"
+#include "config.h"
+#include "bench.h"
+#include "std_types.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                          Definitions                                        *
+ *******************************************************************************/
+#define KEYPAD_QUEUE_SIZE       16   // Keys typed ahead of the flows, a power of 2
+#define LINK_RX_BUFFER_SIZE     16   // Received bytes waiting for the flows, a power of 2
+#define LINK_TIMEOUT_MS         2000 // Longest wait for an answer of the control ECU
+#define LINK_PIR_TIMEOUT_MS     60000 // Longest wait for a PIR report, then the link is resynced
+#define UI_MESSAGE_MS           2000 // Failure messages
+#define PASSWORD_CHANGE_TRIES   3    // New password entries that don't match, then back to the menu
+#define UI_DEADLINE_MS          1000 // Supervisor: longest pass of the flows (UART writes)
+
+#if (KEYPAD_TICK_US < LCD_FB_TICK_US)
+#error "The LCD writes of the keypad tick are too close"
+#endif
+
+/*******************************************************************************
+ *                          Global Variables                                   *
+ *******************************************************************************/
+uint8 match = 0;         // Flag to store password setup confirmation from control ECU
+uint8 match2 = 0;        // Flag to store login status from control ECU
+uint8 try_count = 0;     // Counter for tracking failed login attempts
+uint8 key;
+uint8 session_key[AUTH_KEY_SIZE];  // Key of the last login, used to change the password
+
+UART_ConfigType config = {eight, EVEN, ONE_BIT, 9600};
+
+/* Threads, each one has its own continuation */
+PT_Type pt_ui, pt_request_config, pt_new_password, pt_read_new_password;
+PT_Type pt_password_input, pt_login, pt_login_attempts, pt_change_password;
+PT_Type pt_lockout, pt_door, pt_receive, pt_admin, pt_sync;
+
+/* Keypad: keys pressed, queued by the scan interrupt until a flow takes them */
+Event_Type keypad_events[KEYPAD_QUEUE_SIZE];
+EventQueue_Type keypad_queue;
+uint16 keypad_dropped = 0;   // Overflows already reported
+uint8 key_event;             // EVENT_KEY_PRESS or EVENT_KEY_LONG_PRESS of the last key taken by the menu
+
+/* Supervisor id of the flows, also the id of the watchdog record: 0 */
+uint8 supervisor_ui;
+
+/* Link: bytes received by the RX interrupt, and the state of the receive thread */
+Event_Type link_rx_events[LINK_RX_BUFFER_SIZE];
+EventQueue_Type link_rx_queue;
+uint8 link_ok = 0;        // TRUE if the last block was received in time
+uint8 link_lost = 0;      // TRUE once the control ECU stopped answering, the flows resync
+uint8 enrolled = 0;       // TRUE if the control ECU has a password
+uint8 link_count;
+uint8 link_got;
+uint32 link_deadline;
+
+/* State of the flows, kept across the waits */
+uint8 password[CONFIG_PASSWORD_MAX_LENGTH];
+uint8 re_entered[CONFIG_PASSWORD_MAX_LENGTH];
+uint8 pass_counter;
+uint8 input_key;
+uint8 read_matched;
+uint8 salt[HASH_SALT_SIZE];
+uint8 nonce[AUTH_NONCE_SIZE];
+uint8 block[AUTH_RESPONSE_SIZE];
+uint8 expected[AUTH_RESPONSE_SIZE];
+uint8 secret[AUTH_SECRET_SIZE];
+uint8 reply_signal;
+uint8 pir_receive = 0;    // PIR sensor status from control ECU
+uint8 config_try;
+uint8 config_block[CONFIG_SIZE];
+uint32 ui_deadline;       // End of the current timed screen
+uint8 lockout_left;       // Seconds of lockout shown
+uint8 change_try;         // Entries of the new password
+
+/*******************************************************************************
+ *                          Function Definitions                               *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * RX complete interrupt: keeps the byte for the flows, a full buffer drops it.
+ */
+void link_receive_callback(uint8 data) {
+	Event_Type event = { EVENT_UART_RX, 0, 0 };
+
+	event.data = data;
+	EventQueue_push(&link_rx_queue, &event);
+}
+
+/*
+ * Description:
+ * Takes the next received byte, returns FALSE if there is none.
+ */
+uint8 link_pop(uint8* data) {
+	Event_Type event;
+
+	if (!EventQueue_pop(&link_rx_queue, &event)) {
+		return FALSE;
+	}
+	*data = event.data;
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Flushes the receive buffer to prevent any leftover bytes from interfering with operations.
+ */
+void UART_flushBuffer(void)
+{
+	EventQueue_flush(&link_rx_queue);
+}
+
+/*
+ * Description:
+ * Sends a block of bytes over UART to the control ECU.
+ */
+void send_block(const uint8* data, uint8 size) {
+	for (uint8 i = 0; i < size; i++) {
+		UART_sendByte(data[i]);
+	}
+}
+
+/*
+ * Description:
+ * Clears the provided buffer by setting each element to 0, so no secret stays in RAM.
+ */
+void clear_buffer(uint8* buffer, uint8 size) {
+	for (uint8 i = 0; i < size; i++) {
+		buffer[i] = 0;
+	}
+}
+
+/*
+ * Description:
+ * Keypad event callback, from the scan interrupt: queues the presses and the long
+ * presses, the flows don't use the other events. A full queue counts the key as dropped.
+ */
+void keypad_event_callback(uint8 event, uint8 pressed) {
+	Event_Type queued = { EVENT_KEY_PRESS, 0, 0 };
+
+	if (event == KEYPAD_EVENT_LONG_PRESS) {
+		queued.id = EVENT_KEY_LONG_PRESS;
+	} else if (event != KEYPAD_EVENT_PRESS) {
+		return;
+	}
+	queued.data = pressed;
+	EventQueue_push(&keypad_queue, &queued);
+}
+
+/*
+ * Description:
+ * Timer0 interrupt: one row of the keypad and one LCD write of the framebuffer.
+ */
+void hmi_tick_callback(void) {
+	KEYPAD_tick();
+	LcdFb_tick();
+}
+
+/*
+ * Description:
+ * Takes the oldest key event, returns its id (EVENT_KEY_PRESS or EVENT_KEY_LONG_PRESS)
+ * or EVENT_NONE if there is none.
+ */
+uint8 keypad_take_event(uint8* pressed) {
+	Event_Type queued;
+
+	if (!EventQueue_pop(&keypad_queue, &queued)) {
+		return EVENT_NONE;
+	}
+	*pressed = queued.data;
+	return queued.id;
+}
+
+/*
+ * Description:
+ * Takes the oldest key pressed, returns FALSE if there is none.
+ * A long press follows the press of its key, it is skipped.
+ */
+uint8 keypad_take(uint8* pressed) {
+	uint8 id;
+
+	do {
+		id = keypad_take_event(pressed);
+	} while (id == EVENT_KEY_LONG_PRESS);
+	return (id == EVENT_KEY_PRESS);
+}
+
+/*
+ * Description:
+ * Returns TRUE if keys were dropped by a full queue since the previous call.
+ */
+uint8 keypad_overflowed(void) {
+	uint16 dropped = EventQueue_getDropped(&keypad_queue);
+
+	if (dropped == keypad_dropped) {
+		return FALSE;
+	}
+	keypad_dropped = dropped;
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Receives a block of bytes over UART from the control ECU.
+ * link_ok is FALSE if the block is not complete within timeout_ms.
+ */
+PT_THREAD(receive_block(PT_Type* pt, uint8* buffer, uint8 size, uint16 timeout_ms)) {
+	PT_BEGIN(pt);
+	link_ok = 0;
+	link_deadline = Tick_deadline(timeout_ms);
+	for (link_count = 0; link_count < size; link_count++) {
+		PT_WAIT_UNTIL(pt, (link_got = link_pop(&buffer[link_count])) || Tick_isExpired(link_deadline));
+		if (!link_got) {
+			PT_EXIT(pt);
+		}
+	}
+	link_ok = 1;
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Handles user input from the keypad, storing a password of the configured length
+ * and displaying '*' for each digit entered on the LCD.
+ * The keys typed ahead are taken from the queue, if some were lost because it was
+ * full the entry can't be right: it is read again.
+ */
+PT_THREAD(handle_password_input(PT_Type* pt, uint8* entry)) {
+	PT_BEGIN(pt);
+	keypad_overflowed(); // Only the keys lost during this entry count
+
+	while (1) {
+		// Loop until the whole password is entered
+		for (pass_counter = 0; pass_counter < g_config.password_length; pass_counter++) {
+			PT_WAIT_UNTIL(pt, keypad_take(&input_key) && (input_key <= 16));
+			entry[pass_counter] = input_key;
+			LcdFb_displayCharacter('*');
+		}
+
+		// Wait until the user confirms input with '='
+		PT_WAIT_UNTIL(pt, keypad_take(&input_key) && (input_key == '='));
+		if (!keypad_overflowed()) {
+			break;
+		}
+		EventQueue_flush(&keypad_queue);
+		Screen_show(SCREEN_RETYPE_PASS);
+	}
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Reads the new password twice on the keypad, read_matched is 1 if both entries match.
+ * The confirmation is done locally, so the password itself never goes on the link.
+ */
+PT_THREAD(read_new_password(PT_Type* pt)) {
+	PT_BEGIN(pt);
+
+	// Prompt for the initial password input
+	Screen_show(SCREEN_ENTER_PASS);
+	PT_SPAWN(pt, &pt_password_input, handle_password_input(&pt_password_input, password));
+
+	// Prompt to re-enter the password for confirmation
+	Screen_show(SCREEN_REENTER_PASS);
+	PT_SPAWN(pt, &pt_password_input, handle_password_input(&pt_password_input, re_entered));
+
+	read_matched = HASH_isEqual(password, re_entered, g_config.password_length);
+	clear_buffer(re_entered, CONFIG_PASSWORD_MAX_LENGTH);
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Initiates the process of setting a new password and enrolls it in the control ECU.
+ * Only the verifier (derived from the password with the salt chosen by the control ECU)
+ * is sent, encrypted with the enrollment key of the nonce.
+ */
+PT_THREAD(new_password(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	match = 0;
+
+	PT_SPAWN(pt, &pt_read_new_password, read_new_password(&pt_read_new_password));
+	if (read_matched) {
+		UART_flushBuffer();
+		UART_sendByte(AUTH_ENROLL_REQUEST);
+		PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, salt, HASH_SALT_SIZE, LINK_TIMEOUT_MS));
+		if (link_ok) {
+			PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, nonce, AUTH_NONCE_SIZE, LINK_TIMEOUT_MS));
+		}
+		if (link_ok) {
+			AUTH_deriveSecret(salt, password, g_config.password_length, secret);
+			AUTH_deriveVerifier(salt, secret, block);
+			AUTH_deriveEnrollKey(nonce, session_key);
+			XTEA_encrypt(session_key, block);
+			clear_buffer(session_key, AUTH_KEY_SIZE);
+			send_block(block, HASH_DIGEST_SIZE);
+
+			// Receive confirmation from control ECU
+			PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, &reply_signal, 1, LINK_TIMEOUT_MS));
+			match = link_ok && (reply_signal == AUTH_SUCCESS_SIGNAL);
+			clear_buffer(block, HASH_DIGEST_SIZE);
+		}
+	}
+	clear_buffer(secret, AUTH_SECRET_SIZE);
+	clear_buffer(password, CONFIG_PASSWORD_MAX_LENGTH);
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Replaces the password after a successful login. The new verifier is sent encrypted
+ * with the session key, and the control ECU acknowledges the change with the MAC of
+ * the new verifier under the session key.
+ */
+PT_THREAD(change_password(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	match = 0;
+
+	PT_SPAWN(pt, &pt_read_new_password, read_new_password(&pt_read_new_password));
+	if (read_matched) {
+		UART_sendByte(AUTH_REKEY_REQUEST);
+		PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, salt, HASH_SALT_SIZE, LINK_TIMEOUT_MS));
+		if (link_ok) {
+			AUTH_deriveSecret(salt, password, g_config.password_length, secret);
+			AUTH_deriveVerifier(salt, secret, block);
+			clear_buffer(secret, AUTH_SECRET_SIZE);
+			AUTH_computeMac(session_key, block, HASH_DIGEST_SIZE, expected);
+			XTEA_encrypt(session_key, block);
+			send_block(block, HASH_DIGEST_SIZE);
+
+			// Accept only an acknowledge of this verifier under the key of this session
+			PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, &reply_signal, 1, LINK_TIMEOUT_MS));
+			if (link_ok && (reply_signal == AUTH_SUCCESS_SIGNAL)) {
+				PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, block, AUTH_MAC_SIZE, LINK_TIMEOUT_MS));
+				match = link_ok && HASH_isEqual(block, expected, AUTH_MAC_SIZE);
+			}
+		}
+		link_lost = !link_ok;
+	}
+	clear_buffer(password, CONFIG_PASSWORD_MAX_LENGTH);
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Initiates the login process by requesting password entry and proving it to the control ECU
+ * with a challenge-response exchange, neither the password nor its secret is sent.
+ */
+PT_THREAD(login_password(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	match2 = 0;
+
+	Screen_show(SCREEN_OLD_PASS);
+
+	PT_SPAWN(pt, &pt_password_input, handle_password_input(&pt_password_input, password));
+
+	// Clear any remaining data in the UART buffer
+	UART_flushBuffer();
+
+	// Request a challenge and answer it with the secret derived from the password, masked
+	UART_sendByte(AUTH_CHALLENGE_REQUEST);
+	PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, salt, HASH_SALT_SIZE, LINK_TIMEOUT_MS));
+	if (link_ok) {
+		PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, nonce, AUTH_NONCE_SIZE, LINK_TIMEOUT_MS));
+	}
+	if (link_ok) {
+		AUTH_deriveSecret(salt, password, g_config.password_length, secret);
+		AUTH_deriveVerifier(salt, secret, block);
+		AUTH_maskSecret(block, nonce, secret, block);
+		send_block(block, AUTH_RESPONSE_SIZE);
+		AUTH_deriveSessionKey(secret, nonce, session_key);
+		clear_buffer(secret, AUTH_SECRET_SIZE);
+
+		// Wait for the response from control ECU, only an authentic acknowledge unlocks
+		PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, &reply_signal, 1, LINK_TIMEOUT_MS));
+		if (link_ok && (reply_signal == AUTH_SUCCESS_SIGNAL)) {
+			PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, block, AUTH_RESPONSE_SIZE, LINK_TIMEOUT_MS));
+			AUTH_computeAck(session_key, nonce, expected);
+			match2 = link_ok && HASH_isEqual(block, expected, AUTH_RESPONSE_SIZE);
+		} else if (link_ok && (reply_signal != AUTH_FAILURE_SIGNAL)) {
+			link_ok = 0; // Not an answer to the proof, the control ECU restarted
+		}
+	}
+	// No answer is not a wrong password: the attempt doesn't count, the link is resynced
+	link_lost = !link_ok;
+	clear_buffer(password, CONFIG_PASSWORD_MAX_LENGTH);
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Repeats the login until it succeeds, the configured number of attempts is reached
+ * or the control ECU stops answering.
+ */
+PT_THREAD(login_attempts(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	while ((match2 == 0) && !link_lost && (try_count < g_config.max_attempts)) {
+		PT_SPAWN(pt, &pt_login, login_password(&pt_login));
+		if ((match2 == 0) && !link_lost) {
+			try_count++;
+		}
+	}
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Requests the configuration from the control ECU, so both ECUs use the same timings.
+ * The control ECU may still be starting, so the request is repeated a few times
+ * before falling back to the default configuration.
+ */
+PT_THREAD(request_config(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	for (config_try = 0; config_try < 10; config_try++) {
+		UART_flushBuffer();
+		UART_sendByte(CONFIG_REQUEST);
+		PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, config_block, CONFIG_SIZE, 500));
+		if (link_ok && Config_isValid((const Config_Type*)config_block)) {
+			g_config = *(const Config_Type*)config_block;
+			PT_EXIT(pt);
+		}
+	}
+	Config_setDefaults(&g_config);
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Resync with the control ECU, at boot and after it stopped answering (one of the
+ * ECUs restarted): the configuration, then whether a password is enrolled.
+ * link_lost stays TRUE if the control ECU doesn't answer.
+ */
+PT_THREAD(sync_link(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	PT_SPAWN(pt, &pt_request_config, request_config(&pt_request_config));
+	UART_flushBuffer();
+	UART_sendByte(AUTH_STATUS_REQUEST);
+	PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, &reply_signal, 1, LINK_TIMEOUT_MS));
+	link_lost = !link_ok || ((reply_signal != AUTH_SUCCESS_SIGNAL) && (reply_signal != AUTH_FAILURE_SIGNAL));
+	enrolled = (reply_signal == AUTH_SUCCESS_SIGNAL);
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Displays the home page options on the LCD for opening the door or changing the password.
+ */
+void Home_page_display(void) {
+	Screen_show(SCREEN_HOME);
+}
+
+/*
+ * Description:
+ * Resets the flag variables and counters to initial states.
+ */
+void reset_flags() {
+	match = 0;
+	match2 = 0;
+	try_count = 0;
+	link_lost = 0;
+}
+
+/*
+ * Description:
+ * Displays the lock screen with the seconds left after too many failed attempts.
+ */
+PT_THREAD(lockout(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	Screen_show(SCREEN_LOCKED);
+	ui_deadline = Tick_deadline(0);
+	for (lockout_left = g_config.lockout_duration; lockout_left > 0; lockout_left--) {
+		Screen_setNumber(0, lockout_left);
+		ui_deadline += TICK_SECONDS(1); // From the previous second, the redraw doesn't delay the count
+		PT_WAIT_UNTIL(pt, Tick_isExpired(ui_deadline));
+	}
+	reset_flags();
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Shows the door cycle: unlocking, waiting while people are detected, then locking.
+ * Without a report in time, or after a restart of the control ECU, the state of the
+ * door is unknown: link_lost is set and the cycle is left.
+ */
+PT_THREAD(door_sequence(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	ui_deadline = Tick_deadline(TICK_SECONDS(g_config.door_operation_duration));
+	Screen_show(SCREEN_UNLOCKING);
+	PT_WAIT_UNTIL(pt, Tick_isExpired(ui_deadline));
+
+	PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, &pir_receive, 1, LINK_PIR_TIMEOUT_MS));
+	if (link_ok && (pir_receive == 1)) {
+		Screen_show(SCREEN_WAIT_PEOPLE);
+		do {
+			PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, &pir_receive, 1, LINK_PIR_TIMEOUT_MS));
+		} while (link_ok && (pir_receive == 1));
+	}
+	if (!link_ok || (pir_receive != 0)) {
+		link_lost = 1;
+		PT_EXIT(pt);
+	}
+
+	ui_deadline = Tick_deadline(TICK_SECONDS(g_config.door_operation_duration));
+	Screen_show(SCREEN_LOCKING);
+	PT_WAIT_UNTIL(pt, Tick_isExpired(ui_deadline));
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Admin shortcut, '=' held on the home menu: shows the configuration in use
+ * without a request to the control ECU, until a key is pressed.
+ */
+PT_THREAD(admin_status(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	Screen_show(SCREEN_ADMIN);
+	Screen_setNumber(0, g_config.password_length);
+	Screen_setNumber(1, g_config.max_attempts);
+	Screen_setNumber(2, g_config.door_operation_duration);
+	Screen_setNumber(3, g_config.lockout_duration);
+	PT_WAIT_UNTIL(pt, keypad_take(&input_key));
+	PT_END(pt);
+}
+
+/*
+ * Description:
+ * Main flow: sync with the control ECU, the password setup if it has none, then the
+ * home menu until the control ECU stops answering, and again.
+ */
+PT_THREAD(ui_thread(PT_Type* pt)) {
+	PT_BEGIN(pt);
+	while (1) {
+		reset_flags();
+		PT_SPAWN(pt, &pt_sync, sync_link(&pt_sync)); // Shared configuration and enrollment state
+
+		/* Password Setup Phase, only while the control ECU has no password */
+		while (!enrolled && !link_lost) {
+			// Wait for confirmation of successful password setup
+			PT_SPAWN(pt, &pt_new_password, new_password(&pt_new_password));
+			if (match == 1) {
+				enrolled = 1;
+			} else if (read_matched) {
+				link_lost = 1; // Sent without a confirmation: resync, it may be enrolled
+			} else {
+				// No home menu yet: the entry is typed again
+				Screen_show(SCREEN_MISMATCH);
+				PT_SLEEP(pt, ui_deadline, UI_MESSAGE_MS);
+			}
+		}
+
+		/* Main Control Loop */
+		while (!link_lost) {
+			Home_page_display();
+			reset_flags();
+			EventQueue_flush(&keypad_queue); // A key pressed during the previous screen is not a menu choice
+			PT_WAIT_UNTIL(pt, (key_event = keypad_take_event(&key))
+					&& (((key_event == EVENT_KEY_PRESS) && ((key == '+') || (key == '-')))
+					|| ((key_event == EVENT_KEY_LONG_PRESS) && (key == '='))));
+
+			if (key_event == EVENT_KEY_LONG_PRESS) {
+				PT_SPAWN(pt, &pt_admin, admin_status(&pt_admin));
+				continue;
+			}
+
+			/* Main Option Selection, the control ECU answers busy while the door is in a cycle */
+			UART_flushBuffer();
+			UART_sendByte(key);
+			PT_SPAWN(pt, &pt_receive, receive_block(&pt_receive, &reply_signal, 1, LINK_TIMEOUT_MS));
+			if (link_ok && (reply_signal == AUTH_BUSY_SIGNAL)) {
+				Screen_show(SCREEN_DOOR_BUSY);
+				PT_SLEEP(pt, ui_deadline, UI_MESSAGE_MS);
+				continue;
+			}
+			if (!link_ok || (reply_signal != AUTH_SUCCESS_SIGNAL)) {
+				link_lost = 1;
+				continue;
+			}
+
+			if (key == '+') {  // Door Open Sequence
+				PT_SPAWN(pt, &pt_login_attempts, login_attempts(&pt_login_attempts));
+				clear_buffer(session_key, AUTH_KEY_SIZE);
+				if (link_lost) {
+					continue;
+				}
+				if (match2 == 0) {
+					PT_SPAWN(pt, &pt_lockout, lockout(&pt_lockout));
+					continue;
+				}
+				PT_SPAWN(pt, &pt_door, door_sequence(&pt_door));
+			} else {  // Change Password Sequence
+				PT_SPAWN(pt, &pt_login_attempts, login_attempts(&pt_login_attempts));
+				if (link_lost) {
+					clear_buffer(session_key, AUTH_KEY_SIZE);
+					continue;
+				}
+				if (match2 == 0) {
+					PT_SPAWN(pt, &pt_lockout, lockout(&pt_lockout));
+					continue;
+				}
+				for (change_try = 0; change_try < PASSWORD_CHANGE_TRIES; change_try++) {
+					PT_SPAWN(pt, &pt_change_password, change_password(&pt_change_password));
+					if (read_matched) {
+						break; // Sent: the control ECU ended the session, whatever the answer
+					}
+					Screen_show(SCREEN_MISMATCH);
+					PT_SLEEP(pt, ui_deadline, UI_MESSAGE_MS);
+				}
+				clear_buffer(session_key, AUTH_KEY_SIZE);
+				if ((match != 1) && !link_lost) {
+					Screen_show(SCREEN_CHANGE_FAILED);
+					PT_SLEEP(pt, ui_deadline, UI_MESSAGE_MS);
+				}
+			}
+		}
+
+		// The control ECU stopped answering or restarted: resync before anything else
+		Screen_show(SCREEN_LINK_ERROR);
+		PT_SLEEP(pt, ui_deadline, UI_MESSAGE_MS);
+	}
+	PT_END(pt);
+}
+/*******************************************************************************
+ *                          Main Function                                      *
+ *******************************************************************************/
+int main(void)
+{
+	static const Timer_ConfigType keypad_timer_config = TIMER_CTC_CONFIG(TIMER0_ID, KEYPAD_TICK_US);
+
+	Supervisor_init();      // Completes the record of a watchdog reset
+	SREG |= (1 << 7);       // Enable global interrupts
+	UART_init(&config);     // Initialize UART with configured parameters
+#if BENCH_ENABLE
+	BENCH_runSuite();       // Benchmark firmware: Timer1 is used as cycle counter, never returns
+#endif
+	LCD_init();             // Initialize LCD
+	LcdFb_init();           // The flows write the screen in RAM, the Timer0 interrupt sends the changes
+	System_init();          // Start the millisecond tick used for every duration and the idle sleep
+	EventQueue_init(&link_rx_queue, link_rx_events, LINK_RX_BUFFER_SIZE);
+	UART_setRxCallBack(link_receive_callback);
+	UART_enableRxInterrupt();
+
+	EventQueue_init(&keypad_queue, keypad_events, KEYPAD_QUEUE_SIZE);
+	KEYPAD_init();          // Scanned one row per millisecond by the Timer0 interrupt
+	KEYPAD_setEventCallBack(keypad_event_callback);
+	Timer_setCallBack(hmi_tick_callback, TIMER0_ID);
+	Timer_init(&keypad_timer_config);
+
+	PT_INIT(&pt_ui);
+	supervisor_ui = Supervisor_register(UI_DEADLINE_MS);
+	Supervisor_start();     // Watchdog enabled from here
+	while (1) {
+		Supervisor_setRunning(supervisor_ui);
+		ui_thread(&pt_ui);
+		Supervisor_setRunning(SUPERVISOR_NO_TASK);
+		Supervisor_checkIn(supervisor_ui);
+		System_idle();      // Software timers, then sleep until the next tick or received byte
+	}
+}
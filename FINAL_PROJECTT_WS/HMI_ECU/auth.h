@@ -0,0 +1,145 @@
+ /******************************************************************************
+ *
+ * Module: AUTH
+ *
+ * File Name: auth.h
+ *
+ * Description: Header file for the HMI <-> Control challenge-response authentication
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef AUTH_H_
+#define AUTH_H_
+
+#include "std_types.h"
+#include "hash.h"
+#include "xtea.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Credential, two one-way steps from the password:
+ * secret   = HASH(salt, password)   only computed by the HMI, never stored nor sent in clear
+ * verifier = HASH(secret, salt)     the only value stored by the control ECU
+ *
+ * Resync, after a reset of either ECU (the other one may be anywhere in an exchange):
+ * 1. Control -> HMI     : AUTH_RESTART_SIGNAL once at boot, ends a door cycle the HMI shows
+ * 2. HMI     -> Control : CONFIG_REQUEST, answered with the configuration (config.h)
+ * 3. HMI     -> Control : AUTH_STATUS_REQUEST
+ * 4. Control -> HMI     : AUTH_SUCCESS_SIGNAL if a password is enrolled (home menu),
+ *                         AUTH_FAILURE_SIGNAL otherwise (enrollment)
+ * The control ECU serves both requests whenever it waits for a request, and leaves an
+ * exchange for them: a block not complete within its timeout is dropped, any other
+ * byte than the expected request ends the exchange and is handled as a request.
+ *
+ * Home menu requests of the HMI: '+' (open the door) and '-' (change the password),
+ * answered at once with AUTH_SUCCESS_SIGNAL then the login exchange follows, or with
+ * AUTH_BUSY_SIGNAL for a '+' while the door is not closed (the request is dropped).
+ *
+ * Login exchange, the password never goes on the link:
+ * 1. HMI     -> Control : AUTH_CHALLENGE_REQUEST
+ * 2. Control -> HMI     : salt (8 bytes) + nonce (8 bytes)
+ * 3. HMI     -> Control : proof = secret XOR HASH(verifier, nonce)
+ * 4. Control -> HMI     : AUTH_SUCCESS_SIGNAL + ack = XTEA(session key, ~nonce)
+ *                         or AUTH_FAILURE_SIGNAL
+ * The control ECU unmasks the secret with each stored verifier and accepts it if
+ * HASH(secret, salt) gives that verifier back. Both ECUs then use a key of this
+ * login only: session key = HASH(secret, nonce || 1) || HASH(secret, nonce || 2).
+ * A verifier read from the EEPROM doesn't give the secret, a recorded proof
+ * doesn't give it without the verifier.
+ *
+ * Enrollment (first setup, only while no password is enrolled): AUTH_ENROLL_REQUEST,
+ * then the salt and a nonce from the control ECU and the verifier from the HMI,
+ * encrypted with the session key of AUTH_LINK_KEY over that nonce.
+ * Password change (after a login): AUTH_REKEY_REQUEST, then the salt and the new
+ * verifier encrypted with the session key, acknowledged with AUTH_SUCCESS_SIGNAL +
+ * MAC(session key, new verifier) (AUTH_FAILURE_SIGNAL if it could not be stored).
+ * The salt is the same for all the users of the site (see credential.h on the
+ * control ECU), the control ECU tries the proof against every stored verifier.
+ *
+ * Note: the nonce makes a recorded exchange useless for a replay, but a short
+ * numeric password can still be searched offline from a recorded exchange.
+ */
+#define AUTH_CHALLENGE_REQUEST  'C'
+#define AUTH_ENROLL_REQUEST     'S'
+#define AUTH_REKEY_REQUEST      'R'
+#define AUTH_STATUS_REQUEST     'Q'
+
+#define AUTH_SUCCESS_SIGNAL     0xA5
+#define AUTH_FAILURE_SIGNAL     0xA6
+#define AUTH_BUSY_SIGNAL        0xA7
+#define AUTH_RESTART_SIGNAL     0xA8
+
+#define AUTH_NONCE_SIZE         XTEA_BLOCK_SIZE
+#define AUTH_RESPONSE_SIZE      XTEA_BLOCK_SIZE
+#define AUTH_KEY_SIZE           XTEA_KEY_SIZE
+#define AUTH_SECRET_SIZE        HASH_DIGEST_SIZE
+#define AUTH_MAC_SIZE           HASH_DIGEST_SIZE
+
+/*
+ * Key shared by the two ECUs of a site, it only protects the enrollment: change it
+ * for every installation, in both ECUs.
+ */
+#define AUTH_LINK_KEY           {0x5B, 0xE1, 0x0C, 0x97, 0x3D, 0x72, 0xA8, 0x46}
+
+/* The secret is used as a HASH key, and the proof is one XTEA block */
+#if((AUTH_SECRET_SIZE != HASH_SALT_SIZE) || (AUTH_SECRET_SIZE != AUTH_RESPONSE_SIZE))
+
+#error "The secret must be the size of a HASH key and of an XTEA block"
+
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * First step, on the HMI: secret = HASH(salt, password).
+ */
+void AUTH_deriveSecret(const uint8 *salt, const uint8 *password, uint8 length, uint8 *secret);
+
+/*
+ * Description :
+ * Second step: verifier = HASH(secret, salt), what the control ECU stores.
+ */
+void AUTH_deriveVerifier(const uint8 *salt, const uint8 *secret, uint8 *verifier);
+
+/*
+ * Description :
+ * XOR the input with HASH(verifier, nonce): masks the secret into the proof on the
+ * HMI, and unmasks it on the control ECU.
+ */
+void AUTH_maskSecret(const uint8 *verifier, const uint8 *nonce, const uint8 *input, uint8 *output);
+
+/*
+ * Description :
+ * Build the session key of a login: HASH(secret, nonce || 1) || HASH(secret, nonce || 2).
+ */
+void AUTH_deriveSessionKey(const uint8 *secret, const uint8 *nonce, uint8 *key);
+
+/*
+ * Description :
+ * Build the key of an enrollment, the session key of AUTH_LINK_KEY over its nonce.
+ */
+void AUTH_deriveEnrollKey(const uint8 *nonce, uint8 *key);
+
+/*
+ * Description :
+ * Compute the acknowledge of a successful login: XTEA(key, ~nonce).
+ * It can't be built from a recorded exchange, so the unlock can't be forged.
+ */
+void AUTH_computeAck(const uint8 *key, const uint8 *nonce, uint8 *ack);
+
+/*
+ * Description :
+ * Compute the MAC of a block sent during a session: HASH keyed with the last
+ * 8 bytes of the session key.
+ */
+void AUTH_computeMac(const uint8 *key, const uint8 *data, uint8 length, uint8 *mac);
+
+#endif /* AUTH_H_ */
@@ -0,0 +1,506 @@
+ /******************************************************************************
+ *
+ * Module: BENCH
+ *
+ * File Name: bench.c
+ *
+ * Description: Source file for the cycle-count benchmark harness
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "bench.h"
+
+#if BENCH_ENABLE /* Nothing is linked in the application build */
+
+#include "timer.h"
+#include "uart.h"
+#include "auth.h"
+#include "system.h"
+#include "event_queue.h"
+#include "keypad.h"
+#include "lcd.h"
+#include "lcd_fb.h"
+#include "screen.h"
+#include "config.h"
+#include "gpio.h"
+#include <avr/io.h>
+#include <util/delay.h>
+#include <stdlib.h> /* For ultoa */
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Event queue flood: one event pushed by Timer0 at this period, for that long */
+#define BENCH_FLOOD_PERIOD_US  50UL
+#define BENCH_FLOOD_MS         100
+
+/* Size of the flooded queue, as the link receive queue */
+#define BENCH_QUEUE_SIZE       16
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Outcome of one flood: every event produced is popped or dropped, never lost */
+typedef struct
+{
+	uint16 produced;
+	uint16 popped;
+	uint16 dropped;
+	uint16 disorder;    /* popped with a sequence number older than the previous one */
+}BENCH_FloodType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static volatile uint16 g_overflows = 0;
+static uint32 g_calibration = 0;
+
+/* Counted by the dynamic timer interrupt, the same work as the system tick */
+static volatile uint32 g_interrupts = 0;
+
+/* Flooded by the Timer0 interrupt, the sequence number is the next event pushed */
+static Event_Type g_events[BENCH_QUEUE_SIZE];
+static EventQueue_Type g_queue;
+static volatile uint16 g_sequence = 0;
+
+/* Debouncers and row of the reference keypad scan */
+static uint8 g_gpioIntegrator[KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS];
+static uint16 g_gpioPressed = 0;
+static uint8 g_gpioRow = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Timer1 overflow callback, extends the 16-bit counter to 32 bits.
+ */
+static void BENCH_overflowCallBack(void);
+
+/*
+ * Timer0 compare match callback, dispatched through the callback pointer.
+ */
+static void BENCH_interruptCallBack(void);
+
+/*
+ * Wait for the interrupt flag then return the cycles of one window of interrupts
+ * enabled: the entry, the ISR and the return.
+ */
+static uint32 BENCH_interruptCycles(uint8 flag);
+
+/*
+ * The keypad tick before the port-level scan: the same debouncer with a GPIO call
+ * per pin, kept as the reference of the keypad cases. No event is reported.
+ */
+static void BENCH_gpioKeypadTick(void);
+
+/*
+ * Timer0 compare match callback, the producer of the flood.
+ */
+static void BENCH_floodCallBack(void);
+
+/*
+ * Flood the queue from Timer0 while the main loop pops, spending work x 10 us
+ * on every event popped. The queue is drained after the timer is stopped.
+ */
+static void BENCH_floodQueue(uint8 work, BENCH_FloodType *result);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void BENCH_init(void)
+{
+	Timer_ConfigType bench_timer_config = {0, 0, TIMER1_ID, TIMER0_1_PRESCALER_1, NORMAL_MODE};
+
+	Timer_setCallBack(BENCH_overflowCallBack, TIMER1_ID);
+	Timer_init(&bench_timer_config);
+
+	/* Calibrate with an empty measurement */
+	g_calibration = 0;
+	BENCH_start();
+	g_calibration = BENCH_stop();
+}
+
+void BENCH_start(void)
+{
+	uint8 sreg = SREG;
+
+	SREG &= ~(1 << 7);
+	TIFR = (1 << TOV1); /* Clear any pending overflow */
+	g_overflows = 0;
+	TCNT1 = 0;
+	SREG = sreg;
+}
+
+uint32 BENCH_stop(void)
+{
+	uint8 sreg = SREG;
+	uint16 count;
+	uint16 overflows;
+	uint32 cycles;
+
+	SREG &= ~(1 << 7);
+	count = TCNT1;
+	overflows = g_overflows;
+	/* An overflow happened but its interrupt is still pending */
+	if((TIFR & (1 << TOV1)) && (count < 0x8000))
+	{
+		overflows++;
+	}
+	SREG = sreg;
+
+	cycles = ((uint32)overflows << 16) | count;
+	return (cycles > g_calibration) ? (cycles - g_calibration) : 0;
+}
+
+void BENCH_report(const char *name, uint32 cycles)
+{
+	char buff[11]; /* String to hold the ascii result */
+
+	UART_sendString((const uint8 *)name);
+	UART_sendString((const uint8 *)": ");
+	UART_sendString((const uint8 *)ultoa(cycles, buff, 10));
+	UART_sendString((const uint8 *)" cycles, ");
+	UART_sendString((const uint8 *)ultoa(cycles / (F_CPU / 1000000UL), buff, 10));
+	UART_sendString((const uint8 *)" us\r\n");
+}
+
+void BENCH_reportCount(const char *name, uint32 count)
+{
+	char buff[11]; /* String to hold the ascii result */
+
+	UART_sendString((const uint8 *)name);
+	UART_sendString((const uint8 *)": ");
+	UART_sendString((const uint8 *)ultoa(count, buff, 10));
+	UART_sendString((const uint8 *)"\r\n");
+}
+
+void BENCH_runSuite(void)
+{
+	uint8 salt[HASH_SALT_SIZE] = {0x3A, 0x91, 0x5C, 0x07, 0xE2, 0x48, 0xB6, 0x1D};
+	uint8 nonce[AUTH_NONCE_SIZE] = {0xC4, 0x0B, 0x7E, 0x21, 0x95, 0x5F, 0xA8, 0x36};
+	uint8 password[5] = {1, 2, 3, 4, 5};
+	uint8 key[AUTH_KEY_SIZE];
+	uint8 secret[AUTH_SECRET_SIZE];
+	uint8 block[AUTH_RESPONSE_SIZE];
+	uint8 expected[AUTH_RESPONSE_SIZE];
+	uint32 deadline;
+	uint32 before;
+	uint32 asleep;
+	uint32 total;
+	uint8 i;
+
+	BENCH_init();
+
+	/* HMI side of one login: secret, verifier, proof and session key */
+	BENCH_start();
+	AUTH_deriveSecret(salt, password, sizeof(password), secret);
+	AUTH_deriveVerifier(salt, secret, block);
+	AUTH_maskSecret(block, nonce, secret, block);
+	AUTH_deriveSessionKey(secret, nonce, key);
+	BENCH_report("login_response", BENCH_stop());
+
+	/* Check of the unlock acknowledge */
+	BENCH_start();
+	AUTH_computeAck(key, nonce, expected);
+	HASH_isEqual(block, expected, AUTH_RESPONSE_SIZE);
+	BENCH_report("ack_verify", BENCH_stop());
+
+	BENCH_start();
+	XTEA_encrypt(key, block);
+	BENCH_report("xtea_encrypt", BENCH_stop());
+
+	/*
+	 * Keypad scan interrupt work: one row per tick, a full matrix every 4 ticks.
+	 * Port-level scan against the previous scan through the GPIO driver.
+	 */
+	KEYPAD_init();
+	BENCH_start();
+	KEYPAD_tick();
+	BENCH_report("keypad_tick", BENCH_stop());
+
+	BENCH_start();
+	for(i = 0; i < KEYPAD_NUM_ROWS; i++)
+	{
+		KEYPAD_tick();
+	}
+	BENCH_report("keypad_matrix_scan", BENCH_stop());
+
+	BENCH_start();
+	for(i = 0; i < KEYPAD_NUM_ROWS; i++)
+	{
+		BENCH_gpioKeypadTick();
+	}
+	BENCH_report("keypad_matrix_scan_gpio", BENCH_stop());
+	KEYPAD_init();
+
+	/*
+	 * LCD: one character, then a full screen redraw as the HMI pages do it (clear
+	 * then the two rows). Every write waits for the LCD: its busy flag or the
+	 * execution time of the instruction (see LCD_USE_BUSY_FLAG).
+	 */
+	LCD_init();
+	BENCH_start();
+	LCD_displayCharacter('A');
+	BENCH_report("lcd_character", BENCH_stop());
+
+	/* The bus transfer alone: one port write per byte, two in 4-bit mode (LCD_DATA_BITS_MODE) */
+	BENCH_start();
+	LCD_displayCharacterNoWait('B');
+	BENCH_report("lcd_character_transfer", BENCH_stop());
+	_delay_us(LCD_INSTRUCTION_US);
+
+	BENCH_start();
+	LCD_clearScreen();
+	LCD_displayStringRowColumn(0, 0, "Door is Unlocked");
+	LCD_displayStringRowColumn(1, 0, "Enter Password: ");
+	BENCH_report("lcd_redraw", BENCH_stop());
+
+	/*
+	 * The same redraw through the framebuffer: no clear, only the cells that differ
+	 * from the previous screen are sent. Then one cell changed, as a password digit.
+	 */
+	LcdFb_init();
+	LcdFb_displayStringRowColumn(0, 0, "Door is Unlocked");
+	LcdFb_displayStringRowColumn(1, 0, "Enter Password: ");
+	LcdFb_flush();
+	BENCH_start();
+	LcdFb_clear();
+	LcdFb_displayStringRowColumn(0, 0, "Door is Locked");
+	LcdFb_displayStringRowColumn(1, 0, "Enter Password:*");
+	LcdFb_flush();
+	BENCH_report("lcd_fb_redraw", BENCH_stop());
+
+	BENCH_start();
+	LcdFb_displayStringRowColumn(1, 15, "#");
+	LcdFb_flush();
+	BENCH_report("lcd_fb_character", BENCH_stop());
+
+	/* Interrupt work of the background writer: the cursor command, then the cell */
+	LcdFb_displayStringRowColumn(1, 15, "*");
+	BENCH_start();
+	LcdFb_tick();
+	BENCH_report("lcd_fb_tick_command", BENCH_stop());
+
+	BENCH_start();
+	LcdFb_tick();
+	BENCH_report("lcd_fb_tick_character", BENCH_stop());
+
+	/* A template with its fields, then the LCD writes it costs from the previous screen */
+	BENCH_start();
+	Screen_show(SCREEN_ADMIN);
+	Screen_setNumber(0, CONFIG_DEFAULT_PASSWORD_LENGTH);
+	Screen_setNumber(1, CONFIG_DEFAULT_MAX_ATTEMPTS);
+	Screen_setNumber(2, CONFIG_DEFAULT_DOOR_DURATION);
+	Screen_setNumber(3, CONFIG_DEFAULT_LOCKOUT_DURATION);
+	BENCH_report("screen_render", BENCH_stop());
+
+	BENCH_start();
+	LcdFb_flush();
+	BENCH_report("screen_flush", BENCH_stop());
+
+	System_init();
+	/*
+	 * Timer ISR dispatch: the tick vector is bound at compile time, Timer0 goes through
+	 * the callback pointer with the same body. The difference is the cost of the
+	 * dynamic dispatch paid on every interrupt.
+	 */
+	{
+		const Timer_ConfigType dynamic_timer_config = TIMER_CTC_CONFIG(TIMER0_ID, 1000UL);
+		uint32 window;
+
+		/* Empty window: no interrupt pending */
+		SREG &= ~(1 << 7);
+		BENCH_start();
+		SREG |= (1 << 7);
+		__asm__ __volatile__ ("nop");
+		SREG &= ~(1 << 7);
+		window = BENCH_stop();
+		SREG |= (1 << 7);
+
+		BENCH_report("isr_static", BENCH_interruptCycles(1 << OCF2) - window);
+
+		Timer_setCallBack(BENCH_interruptCallBack, TIMER0_ID);
+		Timer_init(&dynamic_timer_config);
+		TIMSK &= ~(1 << OCIE2); /* Only the Timer0 interrupt in the window */
+		BENCH_report("isr_dynamic", BENCH_interruptCycles(1 << OCF0) - window);
+		TIMSK |= (1 << OCIE2);
+		Timer_deInit(TIMER0_ID);
+	}
+
+	/*
+	 * Event queue: one push and one pop with no interrupt, then a flood from the
+	 * Timer0 interrupt. With a fast consumer nothing is dropped, with a consumer
+	 * slower than the producer the queue overflows: the drops must be counted
+	 * (produced = popped + dropped) and the order kept (disorder = 0).
+	 */
+	{
+		Event_Type event = {EVENT_TIMER, 0, 0};
+		BENCH_FloodType flood;
+
+		EventQueue_init(&g_queue, g_events, BENCH_QUEUE_SIZE);
+		BENCH_start();
+		EventQueue_push(&g_queue, &event);
+		BENCH_report("event_push", BENCH_stop());
+
+		BENCH_start();
+		EventQueue_pop(&g_queue, &event);
+		BENCH_report("event_pop", BENCH_stop());
+
+		BENCH_floodQueue(0, &flood);
+		BENCH_reportCount("flood_fast_produced", flood.produced);
+		BENCH_reportCount("flood_fast_popped", flood.popped);
+		BENCH_reportCount("flood_fast_dropped", flood.dropped);
+		BENCH_reportCount("flood_fast_disorder", flood.disorder);
+
+		BENCH_floodQueue(10, &flood);
+		BENCH_reportCount("flood_slow_produced", flood.produced);
+		BENCH_reportCount("flood_slow_popped", flood.popped);
+		BENCH_reportCount("flood_slow_dropped", flood.dropped);
+		BENCH_reportCount("flood_slow_disorder", flood.disorder);
+	}
+
+	/*
+	 * Idle wait: the cycle counter keeps running in the idle sleep, so the awake time
+	 * is the total minus the time spent in System_sleep() (interrupts count as asleep).
+	 * A busy wait is awake for the whole total.
+	 */
+	asleep = 0;
+	deadline = Tick_deadline(100);
+	BENCH_start();
+	while(!Tick_isExpired(deadline))
+	{
+		before = BENCH_stop();
+		System_sleep();
+		asleep += BENCH_stop() - before;
+	}
+	total = BENCH_stop();
+	BENCH_report("wait_100ms_total", total);
+	BENCH_report("wait_100ms_awake", total - asleep);
+
+	while(1) {}
+}
+
+static void BENCH_overflowCallBack(void)
+{
+	g_overflows++;
+}
+
+static void BENCH_interruptCallBack(void)
+{
+	g_interrupts++;
+}
+
+static uint32 BENCH_interruptCycles(uint8 flag)
+{
+	uint32 cycles;
+
+	SREG &= ~(1 << 7);
+	TIFR = flag; /* Wait for a new event, not one already pending */
+	while(!(TIFR & flag)) {}
+	BENCH_start();
+	SREG |= (1 << 7);
+	__asm__ __volatile__ ("nop"); /* The pending interrupt is taken here */
+	SREG &= ~(1 << 7);
+	cycles = BENCH_stop();
+	SREG |= (1 << 7);
+	return cycles;
+}
+
+static void BENCH_gpioKeypadTick(void)
+{
+	uint8 col;
+	uint8 button = g_gpioRow * KEYPAD_NUM_COLS;
+	uint16 mask = (uint16)1 << button;
+
+	for(col = 0; col < KEYPAD_NUM_COLS; col++, button++, mask <<= 1)
+	{
+		if(GPIO_readPin(PORTB_ID, KEYPAD_FIRST_COL_PIN_ID+col) == KEYPAD_BUTTON_PRESSED)
+		{
+			if(g_gpioIntegrator[button] < KEYPAD_DEBOUNCE_SAMPLES)
+			{
+				g_gpioIntegrator[button]++;
+				if((g_gpioIntegrator[button] == KEYPAD_DEBOUNCE_SAMPLES) && !(g_gpioPressed & mask))
+				{
+					g_gpioPressed |= mask;
+				}
+			}
+		}
+		else if(g_gpioIntegrator[button] > 0)
+		{
+			g_gpioIntegrator[button]--;
+			if((g_gpioIntegrator[button] == 0) && (g_gpioPressed & mask))
+			{
+				g_gpioPressed &= ~mask;
+			}
+		}
+	}
+
+	GPIO_setupPinDirection(PORTB_ID, KEYPAD_FIRST_ROW_PIN_ID+g_gpioRow, PIN_INPUT);
+	g_gpioRow++;
+	if(g_gpioRow == KEYPAD_NUM_ROWS)
+	{
+		g_gpioRow = 0;
+	}
+	GPIO_setupPinDirection(PORTB_ID, KEYPAD_FIRST_ROW_PIN_ID+g_gpioRow, PIN_OUTPUT);
+	GPIO_writePin(PORTB_ID, KEYPAD_FIRST_ROW_PIN_ID+g_gpioRow, KEYPAD_BUTTON_PRESSED);
+}
+
+static void BENCH_floodCallBack(void)
+{
+	Event_Type event = {EVENT_TIMER, 0, 0};
+
+	event.param = g_sequence++;
+	EventQueue_push(&g_queue, &event);
+}
+
+static void BENCH_floodQueue(uint8 work, BENCH_FloodType *result)
+{
+	const Timer_ConfigType flood_timer_config = TIMER_CTC_CONFIG(TIMER0_ID, BENCH_FLOOD_PERIOD_US);
+	Event_Type event;
+	uint32 deadline;
+	uint16 expected = 0;
+	uint8 running = TRUE;
+	uint8 i;
+
+	result->popped = 0;
+	result->disorder = 0;
+	EventQueue_init(&g_queue, g_events, BENCH_QUEUE_SIZE);
+	g_sequence = 0;
+	Timer_setCallBack(BENCH_floodCallBack, TIMER0_ID);
+	deadline = Tick_deadline(BENCH_FLOOD_MS);
+	Timer_init(&flood_timer_config);
+
+	while(running || !EventQueue_isEmpty(&g_queue))
+	{
+		if(running && Tick_isExpired(deadline))
+		{
+			Timer_deInit(TIMER0_ID);
+			running = FALSE;
+		}
+		if(EventQueue_pop(&g_queue, &event))
+		{
+			/* A drop leaves a gap in the sequence, it never goes back */
+			if((event.id != EVENT_TIMER) || ((uint16)(event.param - expected) >= 0x8000))
+			{
+				result->disorder++;
+			}
+			expected = event.param + 1;
+			result->popped++;
+			for(i = 0; i < work; i++)
+			{
+				_delay_us(10);
+			}
+		}
+	}
+
+	result->produced = g_sequence;
+	result->dropped = EventQueue_getDropped(&g_queue);
+}
+
+#endif /* BENCH_ENABLE */
@@ -0,0 +1,72 @@
+ /******************************************************************************
+ *
+ * Module: BENCH
+ *
+ * File Name: bench.h
+ *
+ * Description: Header file for the cycle-count benchmark harness
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Set to 1 to build the benchmark firmware: main() runs the benchmark suite
+ * and reports the results over UART instead of starting the application.
+ */
+#ifndef BENCH_ENABLE
+#define BENCH_ENABLE 0
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start Timer1 free running at F_CPU (no prescaler) with overflow counting,
+ * and measure the overhead of an empty start/stop pair for the calibration.
+ */
+void BENCH_init(void);
+
+/*
+ * Description :
+ * Start a new measurement.
+ */
+void BENCH_start(void);
+
+/*
+ * Description :
+ * Return the number of CPU cycles since BENCH_start() minus the calibration.
+ */
+uint32 BENCH_stop(void);
+
+/*
+ * Description :
+ * Send one result line "<name>: <cycles> cycles, <us> us" over UART.
+ */
+void BENCH_report(const char *name, uint32 cycles);
+
+/*
+ * Description :
+ * Send one result line "<name>: <count>" over UART, for results that are not times.
+ */
+void BENCH_reportCount(const char *name, uint32 count);
+
+/*
+ * Description :
+ * Run all the benchmark cases of this ECU then stop, it never returns.
+ * UART must be initialized before calling it.
+ */
+void BENCH_runSuite(void);
+
+#endif /* BENCH_H_ */
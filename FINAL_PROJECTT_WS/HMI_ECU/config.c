@@ -0,0 +1,68 @@
+ /******************************************************************************
+ *
+ * Module: CONFIG
+ *
+ * File Name: config.c
+ *
+ * Description: Source file for the runtime configuration record shared by both ECUs
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "config.h"
+#include "crc.h"
+#include "uart.h"
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Number of bytes covered by the CRC */
+#define CONFIG_CRC_LENGTH   (CONFIG_SIZE - sizeof(uint16))
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+Config_Type g_config;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Config_setDefaults(Config_Type *config)
+{
+	config->version = CONFIG_VERSION;
+	config->door_operation_duration = CONFIG_DEFAULT_DOOR_DURATION;
+	config->lockout_duration = CONFIG_DEFAULT_LOCKOUT_DURATION;
+	config->max_attempts = CONFIG_DEFAULT_MAX_ATTEMPTS;
+	config->password_length = CONFIG_DEFAULT_PASSWORD_LENGTH;
+	Config_seal(config);
+}
+
+void Config_seal(Config_Type *config)
+{
+	config->crc = CRC16_compute((const uint8 *)config, CONFIG_CRC_LENGTH);
+}
+
+uint8 Config_isValid(const Config_Type *config)
+{
+	return (config->version == CONFIG_VERSION)
+			&& (config->crc == CRC16_compute((const uint8 *)config, CONFIG_CRC_LENGTH))
+			&& (config->door_operation_duration != 0)
+			&& (config->lockout_duration != 0)
+			&& (config->max_attempts != 0)
+			&& (config->password_length >= CONFIG_PASSWORD_MIN_LENGTH)
+			&& (config->password_length <= CONFIG_PASSWORD_MAX_LENGTH);
+}
+
+void Config_send(const Config_Type *config)
+{
+	const uint8 *bytes = (const uint8 *)config;
+	uint8 i;
+
+	for(i = 0; i < CONFIG_SIZE; i++)
+	{
+		UART_sendByte(bytes[i]);
+	}
+}
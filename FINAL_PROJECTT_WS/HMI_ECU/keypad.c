@@ -1,154 +1,310 @@
- /******************************************************************************
- *
- * Module: KEYPAD
- *
- * File Name: keypad.c
- *
- * Description: Source file for the Keypad driver
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-#include "keypad.h"
-#include "gpio.h"
-#include <util/delay.h>
-
-/*******************************************************************************
- *                      Functions Prototypes(Private)                          *
- *******************************************************************************/
-
-#if (KEYPAD_NUM_COLS == 3)
-/*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x3 keypad
- */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number);
-#elif (KEYPAD_NUM_COLS == 4)
-/*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x4 keypad
- */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
-#endif
-
-/*******************************************************************************
- *                      Functions Definitions                                  *
- *******************************************************************************/
-
-uint8 KEYPAD_getPressedKey(void)
-{
-	uint8 col,row;
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_INPUT);
-
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_INPUT);
-#if(KEYPAD_NUM_COLS == 4)
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_INPUT);
-#endif
-	while(1)
-	{
-		for(row=0 ; row<KEYPAD_NUM_ROWS ; row++) /* loop for rows */
-		{
-			/* 
-			 * Each time setup the direction for all keypad port as input pins,
-			 * except this row will be output pin
-			 */
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
-
-			/* Set/Clear the row output pin */
-			GPIO_writePin(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+row, KEYPAD_BUTTON_PRESSED);
-
-			for(col=0 ; col<KEYPAD_NUM_COLS ; col++) /* loop for columns */
-			{
-				/* Check if the switch is pressed in this column */
-				if(GPIO_readPin(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+col) == KEYPAD_BUTTON_PRESSED)
-				{
-					#if (KEYPAD_NUM_COLS == 3)
-						return KEYPAD_4x3_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-					#elif (KEYPAD_NUM_COLS == 4)
-						return KEYPAD_4x4_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-					#endif
-				}
-			}
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
-			_delay_ms(10); /* Add small delay to fix CPU load issue in proteus */
-		}
-	}	
-}
-
-#if (KEYPAD_NUM_COLS == 3)
-/*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x3 shape
- */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
-{
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 10: keypad_button = '*'; // ASCII Code of *
-				 break;
-		case 11: keypad_button = 0;
-				 break;
-		case 12: keypad_button = '#'; // ASCII Code of #
-				 break;
-		default: keypad_button = button_number;
-				break;
-	}
-	return keypad_button;
-} 
-
-#elif (KEYPAD_NUM_COLS == 4)
-
-/*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x4 shape
- */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number)
-{
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 1: keypad_button = 7;
-				break;
-		case 2: keypad_button = 8;
-				break;
-		case 3: keypad_button = 9;
-				break;
-		case 4: keypad_button = '%'; // ASCII Code of %
-				break;
-		case 5: keypad_button = 4;
-				break;
-		case 6: keypad_button = 5;
-				break;
-		case 7: keypad_button = 6;
-				break;
-		case 8: keypad_button = '*'; /* ASCII Code of '*' */
-				break;
-		case 9: keypad_button = 1;
-				break;
-		case 10: keypad_button = 2;
-				break;
-		case 11: keypad_button = 3;
-				break;
-		case 12: keypad_button = '-'; /* ASCII Code of '-' */
-				break;
-		case 13: keypad_button = 13;  /* ASCII of Enter */
-				break;
-		case 14: keypad_button = 0;
-				break;
-		case 15: keypad_button = '='; /* ASCII Code of '=' */
-				break;
-		case 16: keypad_button = '+'; /* ASCII Code of '+' */
-				break;
-		default: keypad_button = button_number;
-				break;
-	}
-	return keypad_button;
-} 
-
-#endif
+ /******************************************************************************
+ *
+ * Module: KEYPAD
+ *
+ * File Name: keypad.c
+ *
+ * Description: Source file for the Keypad driver
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+#include "keypad.h"
+#include "gpio.h"
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+#define KEYPAD_ROW_MASK     (((1 << KEYPAD_NUM_ROWS) - 1) << KEYPAD_FIRST_ROW_PIN_ID)
+#define KEYPAD_COL_MASK     (((1 << KEYPAD_NUM_COLS) - 1) << KEYPAD_FIRST_COL_PIN_ID)
+
+/* Columns of one row of the matrix state */
+#define KEYPAD_ROW_BITS     ((1 << KEYPAD_NUM_COLS) - 1)
+
+/* Hold durations in scans of the whole matrix */
+#define KEYPAD_SCAN_US          ((uint32)KEYPAD_TICK_US * KEYPAD_NUM_ROWS)
+#define KEYPAD_LONG_PRESS_SCANS ((uint16)(((uint32)KEYPAD_LONG_PRESS_MS * 1000) / KEYPAD_SCAN_US))
+#define KEYPAD_REPEAT_SCANS     ((uint16)(((uint32)KEYPAD_REPEAT_MS * 1000) / KEYPAD_SCAN_US))
+
+#if ((KEYPAD_ROW_MASK & KEYPAD_COL_MASK) != 0) || (KEYPAD_ROW_MASK > 0xFF) || (KEYPAD_COL_MASK > 0xFF)
+#error "The keypad rows and columns must be separate pins of the same 8-bit port"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static volatile void (*g_callBackPtr_event)(uint8, uint8) = NULL_PTR;
+
+/* Debouncers, by button number - 1 (row * KEYPAD_NUM_COLS + col) */
+static uint8 g_integrator[KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS];
+
+/* Debounced state of the matrix, one bit per button, and the ghost keys among them */
+static volatile uint16 g_pressed = 0;
+static uint16 g_ghost = 0;
+
+/* Key held alone, and for how many scans of the matrix */
+static uint16 g_held = 0;
+static uint16 g_heldScans = 0;
+
+/* Row driven now, sampled at the next tick */
+static uint8 g_row = 0;
+
+/*
+ * Key code of every button (button number - 1), in flash: the functional numbers
+ * of the keypad in proteus.
+ */
+#if (KEYPAD_NUM_COLS == 3)
+static const uint8 g_keyCodes[KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS] PROGMEM =
+{
+	1,   2,   3,
+	4,   5,   6,
+	7,   8,   9,
+	'*', 0,   '#'
+};
+#elif (KEYPAD_NUM_COLS == 4)
+static const uint8 g_keyCodes[KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS] PROGMEM =
+{
+	7,   8,   9,   '%',
+	4,   5,   6,   '*',
+	1,   2,   3,   '-',
+	13,  0,   '=', '+'     /* 13: ASCII of Enter */
+};
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Give the event of a button to the callback, with its key code.
+ */
+static void KEYPAD_report(uint8 event, uint8 button);
+
+/*
+ * Return TRUE if two rows of the matrix have 2 pressed columns in common.
+ */
+static uint8 KEYPAD_isAmbiguous(uint16 matrix);
+
+/*
+ * Report the new presses of a row: ghosts if the matrix became ambiguous, else
+ * presses, followed by a chord if other keys are held.
+ */
+static void KEYPAD_reportPresses(uint16 pressed);
+
+/*
+ * After a scan of the whole matrix: long press and repeat of a key held alone.
+ */
+static void KEYPAD_updateHold(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void KEYPAD_init(void)
+{
+	uint8 button;
+
+	/* All the keypad pins are inputs, except the driven row */
+	KEYPAD_PORT_DIR &= (uint8)~(KEYPAD_ROW_MASK | KEYPAD_COL_MASK);
+
+	/* A row is driven to the pressed level, set/clear the output latch of the rows once */
+#if (KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+	KEYPAD_PORT_OUT &= (uint8)~KEYPAD_ROW_MASK;
+#else
+	KEYPAD_PORT_OUT |= KEYPAD_ROW_MASK;
+#endif
+
+	for(button = 0; button < (KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS); button++)
+	{
+		g_integrator[button] = 0;
+	}
+	g_pressed = 0;
+	g_ghost = 0;
+	g_held = 0;
+	g_heldScans = 0;
+
+	g_row = 0;
+	KEYPAD_PORT_DIR |= (1 << KEYPAD_FIRST_ROW_PIN_ID);
+}
+
+void KEYPAD_setEventCallBack(void(*a_ptr)(uint8 event, uint8 key))
+{
+	g_callBackPtr_event = a_ptr;
+}
+
+void KEYPAD_tick(void)
+{
+	uint8 col;
+	uint8 columns;
+	uint8 button = g_row * KEYPAD_NUM_COLS;
+	uint16 mask = (uint16)1 << button;
+	uint16 pressed = 0;
+
+	/* All the columns of the row in one read, a set bit is a pressed switch */
+#if (KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+	columns = (uint8)(~KEYPAD_PORT_IN & KEYPAD_COL_MASK) >> KEYPAD_FIRST_COL_PIN_ID;
+#else
+	columns = (uint8)(KEYPAD_PORT_IN & KEYPAD_COL_MASK) >> KEYPAD_FIRST_COL_PIN_ID;
+#endif
+
+	/* Drive the next row now, it settles until the next tick */
+	g_row++;
+	if(g_row == KEYPAD_NUM_ROWS)
+	{
+		g_row = 0;
+	}
+	KEYPAD_PORT_DIR = (KEYPAD_PORT_DIR & (uint8)~KEYPAD_ROW_MASK) | (1 << (KEYPAD_FIRST_ROW_PIN_ID + g_row));
+
+	for(col = 0; col < KEYPAD_NUM_COLS; col++, button++, mask <<= 1, columns >>= 1) /* loop for columns */
+	{
+		/* Integrate up while the switch is pressed in this column, down while it is released */
+		if(columns & 1)
+		{
+			if(g_integrator[button] < KEYPAD_DEBOUNCE_SAMPLES)
+			{
+				g_integrator[button]++;
+				if((g_integrator[button] == KEYPAD_DEBOUNCE_SAMPLES) && !(g_pressed & mask))
+				{
+					pressed |= mask; /* Reported with the other keys of the row */
+				}
+			}
+		}
+		else if(g_integrator[button] > 0)
+		{
+			g_integrator[button]--;
+			if((g_integrator[button] == 0) && (g_pressed & mask))
+			{
+				g_pressed &= ~mask;
+				if(g_ghost & mask)
+				{
+					g_ghost &= ~mask;
+				}
+				else
+				{
+					KEYPAD_report(KEYPAD_EVENT_RELEASE, button);
+				}
+			}
+		}
+	}
+
+	if(pressed)
+	{
+		KEYPAD_reportPresses(pressed);
+	}
+	if(g_row == 0)
+	{
+		KEYPAD_updateHold();
+	}
+}
+
+uint16 KEYPAD_getPressed(void)
+{
+	uint8 sreg = SREG;
+	uint16 matrix;
+
+	SREG &= ~(1 << 7); /* 2 bytes written by the scan interrupt */
+	matrix = g_pressed;
+	SREG = sreg;
+	return matrix;
+}
+
+uint8 KEYPAD_getKeyCode(uint8 button)
+{
+	return pgm_read_byte(&g_keyCodes[button]);
+}
+
+static void KEYPAD_report(uint8 event, uint8 button)
+{
+	if(g_callBackPtr_event != NULL_PTR)
+	{
+		(*g_callBackPtr_event)(event, pgm_read_byte(&g_keyCodes[button]));
+	}
+}
+
+static uint8 KEYPAD_isAmbiguous(uint16 matrix)
+{
+	uint8 row;
+	uint8 other;
+	uint8 columns;
+	uint8 common;
+
+	for(row = 0; row < (KEYPAD_NUM_ROWS - 1); row++)
+	{
+		columns = (uint8)(matrix >> (row * KEYPAD_NUM_COLS)) & KEYPAD_ROW_BITS;
+		for(other = row + 1; other < KEYPAD_NUM_ROWS; other++)
+		{
+			common = columns & (uint8)(matrix >> (other * KEYPAD_NUM_COLS));
+			if(common & (common - 1)) /* more than one bit */
+			{
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+static void KEYPAD_reportPresses(uint16 pressed)
+{
+	uint8 button;
+	uint16 mask;
+	uint8 ambiguous;
+
+	g_pressed |= pressed;
+	/* Keys read in the same sample can't be told apart: all ghosts or all pressed */
+	ambiguous = KEYPAD_isAmbiguous(g_pressed);
+	if(ambiguous)
+	{
+		g_ghost |= pressed;
+	}
+
+	for(button = 0, mask = 1; button < (KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS); button++, mask <<= 1)
+	{
+		if(pressed & mask)
+		{
+			if(ambiguous)
+			{
+				KEYPAD_report(KEYPAD_EVENT_GHOST, button);
+			}
+			else
+			{
+				KEYPAD_report(KEYPAD_EVENT_PRESS, button);
+				if(g_pressed & ~mask)
+				{
+					KEYPAD_report(KEYPAD_EVENT_CHORD, button);
+				}
+			}
+		}
+	}
+}
+
+static void KEYPAD_updateHold(void)
+{
+	uint8 button;
+
+	/* Exactly one key pressed and no ghost, the same since the previous scan */
+	if((g_ghost != 0) || (g_pressed == 0) || (g_pressed & (g_pressed - 1)) || (g_pressed != g_held))
+	{
+		g_held = g_pressed;
+		g_heldScans = 0;
+		return;
+	}
+
+	g_heldScans++;
+	if((g_heldScans == KEYPAD_LONG_PRESS_SCANS) || (g_heldScans == (KEYPAD_LONG_PRESS_SCANS + KEYPAD_REPEAT_SCANS)))
+	{
+		for(button = 0; !(g_held & ((uint16)1 << button)); button++) {}
+		if(g_heldScans == KEYPAD_LONG_PRESS_SCANS)
+		{
+			KEYPAD_report(KEYPAD_EVENT_LONG_PRESS, button);
+		}
+		else
+		{
+			KEYPAD_report(KEYPAD_EVENT_REPEAT, button);
+			g_heldScans = KEYPAD_LONG_PRESS_SCANS; /* Next repeat after another interval */
+		}
+	}
+}
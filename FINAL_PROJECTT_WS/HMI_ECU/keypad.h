@@ -1,48 +1,116 @@
- /******************************************************************************
- *
- * Module: KEYPAD
- *
- * File Name: keypad.h
- *
- * Description: Header file for the Keypad driver
- *
- * Author: Mohamed Tarek
- *
- *******************************************************************************/
-
-#ifndef KEYPAD_H_
-#define KEYPAD_H_
-
-#include "std_types.h"
-
-/*******************************************************************************
- *                                Definitions                                  *
- *******************************************************************************/
-
-/* Keypad configurations for number of rows and columns */
-#define KEYPAD_NUM_COLS                   4
-#define KEYPAD_NUM_ROWS                   4
-
-/* Keypad Port Configurations */
-#define KEYPAD_ROW_PORT_ID                PORTB_ID
-#define KEYPAD_FIRST_ROW_PIN_ID           PIN0_ID
-
-#define KEYPAD_COL_PORT_ID                PORTB_ID
-#define KEYPAD_FIRST_COL_PIN_ID           PIN4_ID
-
-/* Keypad button logic configurations */
-#define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
-#define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
-
-/*******************************************************************************
- *                      Functions Prototypes                                   *
- *******************************************************************************/
-
-/*
- * Description :
- * Get the Keypad pressed button
- */
-uint8 KEYPAD_getPressedKey(void);
-
-
-#endif /* KEYPAD_H_ */
+ /******************************************************************************
+ *
+ * Module: KEYPAD
+ *
+ * File Name: keypad.h
+ *
+ * Description: Header file for the Keypad driver
+ *
+ * Author: Mohamed Tarek
+ *
+ *******************************************************************************/
+
+#ifndef KEYPAD_H_
+#define KEYPAD_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Keypad configurations for number of rows and columns */
+#define KEYPAD_NUM_COLS                   4
+#define KEYPAD_NUM_ROWS                   4
+
+/*
+ * Keypad Port Configurations: the rows and the columns are two groups of pins of
+ * the same port, each one is driven or read with a single register access.
+ */
+#define KEYPAD_PORT_OUT                   PORTB
+#define KEYPAD_PORT_DIR                   DDRB
+#define KEYPAD_PORT_IN                    PINB
+
+#define KEYPAD_FIRST_ROW_PIN_ID           PIN0_ID
+#define KEYPAD_FIRST_COL_PIN_ID           PIN4_ID
+
+/* Keypad button logic configurations */
+#define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
+#define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
+
+/*
+ * KEYPAD_tick() samples one row per call and drives the next one, every key is
+ * sampled every KEYPAD_NUM_ROWS ticks. It is called from a timer interrupt at
+ * this interval.
+ */
+#define KEYPAD_TICK_US                   1000
+
+/*
+ * Debouncer of every key: +1 per sample pressed, -1 per sample released. The key
+ * is pressed when it reaches KEYPAD_DEBOUNCE_SAMPLES and released when it is back
+ * to 0, so a bounce only delays the event, it never makes another one.
+ * With 4 rows at 1 ms a press is reported 8 to 12 ms after the contact.
+ */
+#define KEYPAD_DEBOUNCE_SAMPLES          3
+
+/*
+ * A key held alone for KEYPAD_LONG_PRESS_MS gives a long press, then a repeat every
+ * KEYPAD_REPEAT_MS while it is held. Counted in scans of the whole matrix.
+ */
+#define KEYPAD_LONG_PRESS_MS             1000
+#define KEYPAD_REPEAT_MS                 250
+
+/* Events given to the callback with the key */
+#define KEYPAD_EVENT_PRESS               0
+#define KEYPAD_EVENT_RELEASE             1
+#define KEYPAD_EVENT_LONG_PRESS          2   /* held alone for KEYPAD_LONG_PRESS_MS */
+#define KEYPAD_EVENT_REPEAT              3   /* still held, every KEYPAD_REPEAT_MS after the long press */
+#define KEYPAD_EVENT_CHORD               4   /* after the press of a key while others are held */
+#define KEYPAD_EVENT_GHOST               5   /* key read but maybe not pressed, see below */
+
+/*
+ * Ghost keys: with 3 keys pressed on the corners of a rectangle (2 rows, 2 columns)
+ * the matrix also reads the 4th corner as pressed, there is no way to tell which
+ * keys are real. A key that completes a rectangle gives KEYPAD_EVENT_GHOST instead
+ * of its press, and nothing when it is released.
+ */
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the keypad pins, all the keys released, and drive the first row.
+ */
+void KEYPAD_init(void);
+
+/*
+ * Description :
+ * Set the function called with every event (KEYPAD_EVENT_PRESS or
+ * KEYPAD_EVENT_RELEASE) and its key, from the context of KEYPAD_tick().
+ */
+void KEYPAD_setEventCallBack(void(*a_ptr)(uint8 event, uint8 key));
+
+/*
+ * Description :
+ * Call it every KEYPAD_TICK_US from a timer interrupt: read the columns of the
+ * row driven since the previous tick (it had the whole period to settle), update
+ * the debouncers of its keys and drive the next row.
+ */
+void KEYPAD_tick(void);
+
+/*
+ * Description :
+ * Return the debounced state of the whole matrix, bit (row * KEYPAD_NUM_COLS + col)
+ * is set while that button is pressed, ghost keys included.
+ */
+uint16 KEYPAD_getPressed(void);
+
+/*
+ * Description :
+ * Return the key code of a button of the matrix (bit number of KEYPAD_getPressed()).
+ */
+uint8 KEYPAD_getKeyCode(uint8 button);
+
+#endif /* KEYPAD_H_ */
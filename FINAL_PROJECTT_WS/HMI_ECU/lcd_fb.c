@@ -0,0 +1,222 @@
+ /******************************************************************************
+ *
+ * Module: LCD_FB
+ *
+ * File Name: lcd_fb.c
+ *
+ * Description: Source file for the shadow framebuffer of the LCD
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "lcd_fb.h"
+#include "lcd.h"
+#include <stdlib.h> /* For itoa */
+#include <avr/pgmspace.h> /* For pgm_read_byte */
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/*
+ * DDRAM address of the first cell of a row: rows 0 and 1 start at 0x00 and 0x40,
+ * rows 2 and 3 continue them just after the last column.
+ */
+#define LCD_FB_ROW_ADDRESS(row)     ((uint8)((((row) & 1) ? 0x40 : 0x00) + (((row) & 2) ? LCD_FB_COLS : 0)))
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Written by the UI, one byte per cell so the tick never reads half a cell */
+static volatile uint8 g_buffer[LCD_FB_ROWS][LCD_FB_COLS];
+
+/* What the LCD shows, only written by the flush or the tick */
+static uint8 g_shown[LCD_FB_ROWS][LCD_FB_COLS];
+
+/* Cursor of the UI */
+static uint8 g_row;
+static uint8 g_col;
+
+/*
+ * Set by every write of the UI. The tick clears it when it starts a pass over the
+ * screen, so a cell written during the pass is seen by the next one.
+ */
+static volatile uint8 g_dirty = FALSE;
+
+/* Pass of the tick: TRUE until its last cell, and its next cell */
+static volatile uint8 g_scanning = FALSE;
+static uint8 g_scanRow;
+static uint8 g_scanCol;
+
+/* DDRAM address of the LCD, 0xFF: unknown */
+static uint8 g_address = 0xFF;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void LcdFb_init(void)
+{
+	uint8 row;
+	uint8 col;
+
+	for(row = 0; row < LCD_FB_ROWS; row++)
+	{
+		for(col = 0; col < LCD_FB_COLS; col++)
+		{
+			g_shown[row][col] = ' ';
+		}
+	}
+	g_scanning = FALSE;
+	g_address = 0xFF;
+	LcdFb_clear();
+}
+
+void LcdFb_clear(void)
+{
+	uint8 row;
+	uint8 col;
+
+	for(row = 0; row < LCD_FB_ROWS; row++)
+	{
+		for(col = 0; col < LCD_FB_COLS; col++)
+		{
+			g_buffer[row][col] = ' ';
+		}
+	}
+	g_row = 0;
+	g_col = 0;
+	g_dirty = TRUE;
+}
+
+void LcdFb_moveCursor(uint8 row, uint8 col)
+{
+	g_row = row;
+	g_col = col;
+}
+
+void LcdFb_displayCharacter(uint8 data)
+{
+	if((g_row < LCD_FB_ROWS) && (g_col < LCD_FB_COLS))
+	{
+		g_buffer[g_row][g_col++] = data;
+		g_dirty = TRUE;
+	}
+}
+
+void LcdFb_displayString(const char *Str)
+{
+	while(*Str != '\0')
+	{
+		LcdFb_displayCharacter(*Str++);
+	}
+}
+
+void LcdFb_displayString_P(const char *Str)
+{
+	uint8 data;
+
+	while((data = pgm_read_byte(Str++)) != '\0')
+	{
+		LcdFb_displayCharacter(data);
+	}
+}
+
+void LcdFb_displayStringRowColumn(uint8 row, uint8 col, const char *Str)
+{
+	LcdFb_moveCursor(row, col);
+	LcdFb_displayString(Str);
+}
+
+void LcdFb_displayStringRowColumn_P(uint8 row, uint8 col, const char *Str)
+{
+	LcdFb_moveCursor(row, col);
+	LcdFb_displayString_P(Str);
+}
+
+void LcdFb_integerToString(int data)
+{
+	char buff[16]; /* String to hold the ascii result */
+
+	itoa(data, buff, 10);
+	LcdFb_displayString(buff);
+}
+
+void LcdFb_flush(void)
+{
+	uint8 row;
+	uint8 col;
+	uint8 address;
+
+	g_dirty = FALSE;
+	for(row = 0; row < LCD_FB_ROWS; row++)
+	{
+		for(col = 0; col < LCD_FB_COLS; col++)
+		{
+			if(g_buffer[row][col] == g_shown[row][col])
+			{
+				continue;
+			}
+
+			/* Only the first cell of a run needs the address */
+			address = LCD_FB_ROW_ADDRESS(row) + col;
+			if(address != g_address)
+			{
+				LCD_sendCommand(LCD_SET_CURSOR_LOCATION | address);
+			}
+			g_shown[row][col] = g_buffer[row][col];
+			LCD_displayCharacter(g_shown[row][col]);
+			g_address = address + 1;
+		}
+	}
+}
+
+void LcdFb_tick(void)
+{
+	uint8 address;
+
+	if(!g_scanning)
+	{
+		if(!g_dirty)
+		{
+			return;
+		}
+		g_dirty = FALSE;
+		g_scanning = TRUE;
+		g_scanRow = 0;
+		g_scanCol = 0;
+	}
+
+	/* Next changed cell */
+	while(g_buffer[g_scanRow][g_scanCol] == g_shown[g_scanRow][g_scanCol])
+	{
+		if(++g_scanCol == LCD_FB_COLS)
+		{
+			g_scanCol = 0;
+			if(++g_scanRow == LCD_FB_ROWS)
+			{
+				g_scanning = FALSE;
+				return;
+			}
+		}
+	}
+
+	/* One write per tick: the address first if the run starts here, the cell at the next tick */
+	address = LCD_FB_ROW_ADDRESS(g_scanRow) + g_scanCol;
+	if(address != g_address)
+	{
+		LCD_sendCommandNoWait(LCD_SET_CURSOR_LOCATION | address);
+		g_address = address;
+		return;
+	}
+	g_shown[g_scanRow][g_scanCol] = g_buffer[g_scanRow][g_scanCol];
+	LCD_displayCharacterNoWait(g_shown[g_scanRow][g_scanCol]);
+	g_address++;
+}
+
+uint8 LcdFb_isFlushed(void)
+{
+	return !g_dirty && !g_scanning;
+}
@@ -0,0 +1,123 @@
+ /******************************************************************************
+ *
+ * Module: LCD_FB
+ *
+ * File Name: lcd_fb.h
+ *
+ * Description: Header file for the shadow framebuffer of the LCD
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef LCD_FB_H_
+#define LCD_FB_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Size of the screen, up to 4 x 20 */
+#define LCD_FB_ROWS                 2
+#define LCD_FB_COLS                 16
+
+#if((LCD_FB_ROWS < 1) || (LCD_FB_ROWS > 4) || (LCD_FB_COLS < 1) || (LCD_FB_COLS > 20))
+
+#error "The LCD framebuffer is 4 rows of 20 columns at most"
+
+#endif
+
+/*
+ * LcdFb_tick() does one LCD write per call, from a timer interrupt at this interval
+ * at least: longer than the execution of a write (LCD_INSTRUCTION_US). A whole 2 x 16
+ * screen takes 34 ticks, a character typed 1 or 2.
+ */
+#define LCD_FB_TICK_US              1000
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Call it just after LCD_init(): the screen is blank, so is the framebuffer.
+ * From then on the screen is only written by LcdFb_flush() or LcdFb_tick().
+ */
+void LcdFb_init(void);
+
+/*
+ * Description :
+ * Blank the framebuffer and move its cursor home. No command is sent to the LCD,
+ * the cells that were not blank are erased by the next flush.
+ */
+void LcdFb_clear(void);
+
+/*
+ * Description :
+ * Move the cursor of the framebuffer, the next characters are written from there.
+ */
+void LcdFb_moveCursor(uint8 row, uint8 col);
+
+/*
+ * Description :
+ * Write a character at the cursor and move it to the next column. The characters
+ * past the end of the row are lost, they don't go to the next row.
+ */
+void LcdFb_displayCharacter(uint8 data);
+
+/*
+ * Description :
+ * Write a string at the cursor.
+ */
+void LcdFb_displayString(const char *Str);
+
+/*
+ * Description :
+ * Write a string stored in the program memory (PSTR() or PROGMEM) at the cursor.
+ */
+void LcdFb_displayString_P(const char *Str);
+
+/*
+ * Description :
+ * Write a string from a specified row and column.
+ */
+void LcdFb_displayStringRowColumn(uint8 row, uint8 col, const char *Str);
+
+/*
+ * Description :
+ * Write a string stored in the program memory from a specified row and column.
+ */
+void LcdFb_displayStringRowColumn_P(uint8 row, uint8 col, const char *Str);
+
+/*
+ * Description :
+ * Write a decimal value at the cursor.
+ */
+void LcdFb_integerToString(int data);
+
+/*
+ * Description :
+ * Send the cells that changed since the previous flush to the LCD and wait for them.
+ * A run of changed cells of a row costs one cursor command, the DDRAM address then
+ * moves by itself after every character. Nothing is sent when nothing changed.
+ * Only while LcdFb_tick() is not called.
+ */
+void LcdFb_flush(void);
+
+/*
+ * Description :
+ * Call it every LCD_FB_TICK_US from a timer interrupt: sends the changed cells in
+ * the background, one cursor command or one character per call, the runs as in
+ * LcdFb_flush(). The UI only writes the framebuffer and goes on.
+ */
+void LcdFb_tick(void);
+
+/*
+ * Description :
+ * Return TRUE when the LCD shows all the writes of the UI.
+ */
+uint8 LcdFb_isFlushed(void);
+
+#endif /* LCD_FB_H_ */
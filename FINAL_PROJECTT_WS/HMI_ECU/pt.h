@@ -0,0 +1,99 @@
+ /******************************************************************************
+ *
+ * Module: PT
+ *
+ * File Name: pt.h
+ *
+ * Description: Stackless coroutines (protothreads) for the HMI flows
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef PT_H_
+#define PT_H_
+
+#include "std_types.h"
+#include "tick.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * A thread is a function written as sequential code between PT_BEGIN and PT_END
+ * that returns at every wait and continues from there at its next call: the only
+ * state kept is the line of the wait (2 bytes), there is no stack per thread.
+ * Rules that follow from it:
+ * - local variables are lost at every wait, keep the state in static variables
+ * - no switch statement around a wait (the waits are case labels of a switch)
+ * - a thread is resumed by calling it again, usually from the main loop
+ */
+#define PT_WAITING      0
+#define PT_YIELDED      1
+#define PT_EXITED       2
+#define PT_ENDED        3
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint16 lc;      /* local continuation: line of the last wait, 0 at the start */
+}PT_Type;
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* Declare a thread function: PT_THREAD(name(PT_Type *pt, ...)) */
+#define PT_THREAD(name_args)        uint8 name_args
+
+#define PT_INIT(pt)                 ((pt)->lc = 0)
+
+#define PT_BEGIN(pt) \
+	{ uint8 pt_yielded = TRUE; (void)pt_yielded; switch((pt)->lc) { case 0:
+
+#define PT_END(pt) \
+	} PT_INIT(pt); return PT_ENDED; }
+
+/* Return until the condition is true, it is evaluated again at every call */
+#define PT_WAIT_UNTIL(pt, condition) \
+	do { \
+		(pt)->lc = __LINE__; case __LINE__: \
+		if(!(condition)) { return PT_WAITING; } \
+	} while(0)
+
+#define PT_WAIT_WHILE(pt, condition)    PT_WAIT_UNTIL((pt), !(condition))
+
+/* TRUE while the thread call did not end */
+#define PT_SCHEDULE(thread_call)        ((thread_call) < PT_EXITED)
+
+/* Start a child thread and wait until it ends */
+#define PT_SPAWN(pt, child, thread_call) \
+	do { \
+		PT_INIT(child); \
+		PT_WAIT_WHILE((pt), PT_SCHEDULE(thread_call)); \
+	} while(0)
+
+/* Give the other threads one turn */
+#define PT_YIELD(pt) \
+	do { \
+		pt_yielded = FALSE; \
+		(pt)->lc = __LINE__; case __LINE__: \
+		if(!pt_yielded) { return PT_YIELDED; } \
+	} while(0)
+
+/* Wait for duration_ms, the deadline must be a static variable */
+#define PT_SLEEP(pt, deadline, duration_ms) \
+	do { \
+		(deadline) = Tick_deadline(duration_ms); \
+		PT_WAIT_UNTIL((pt), Tick_isExpired(deadline)); \
+	} while(0)
+
+/* End the thread now, its parent continues */
+#define PT_EXIT(pt) \
+	do { PT_INIT(pt); return PT_EXITED; } while(0)
+
+#endif /* PT_H_ */
@@ -0,0 +1,149 @@
+ /******************************************************************************
+ *
+ * Module: SCREEN
+ *
+ * File Name: screen.c
+ *
+ * Description: Source file for the screen templates of the HMI
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "screen.h"
+#include "config.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint8 row;
+	uint8 col;
+	uint8 width;
+}Screen_FieldType;
+
+typedef struct
+{
+	char image[SCREEN_ROWS][SCREEN_COLS];   /* every cell, no terminator */
+	uint8 fields;
+	Screen_FieldType field[SCREEN_MAX_FIELDS];
+}Screen_TemplateType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* The password fields start at column 8 at most, the longest password must fit */
+#if((SCREEN_COLS - 8) < CONFIG_PASSWORD_MAX_LENGTH)
+#error "The password fields of the screens are too short"
+#endif
+
+/* In the order of Screen_IdType, the cells of a field are blank */
+static const Screen_TemplateType g_screens[SCREEN_COUNT] PROGMEM =
+{
+	/* SCREEN_HOME */
+	{{"+ : OPEN DOOR   ",
+	  "- : CHANGE PASS "}, 0, {{0, 0, 0}}},
+	/* SCREEN_ENTER_PASS */
+	{{"Plz Enter Pass: ",
+	  "                "}, 1, {{1, 0, CONFIG_PASSWORD_MAX_LENGTH}}},
+	/* SCREEN_REENTER_PASS */
+	{{"Plz re-Enter the",
+	  "pass:           "}, 1, {{1, 5, CONFIG_PASSWORD_MAX_LENGTH}}},
+	/* SCREEN_OLD_PASS */
+	{{"Please Enter old",
+	  "Pass:           "}, 1, {{1, 5, CONFIG_PASSWORD_MAX_LENGTH}}},
+	/* SCREEN_LOCKED */
+	{{"System LOCKED   ",
+	  "Wait for     sec"}, 1, {{1, 9, 3}}},
+	/* SCREEN_UNLOCKING */
+	{{"Door Unlocking  ",
+	  "Please wait     "}, 0, {{0, 0, 0}}},
+	/* SCREEN_WAIT_PEOPLE */
+	{{"Wait for people ",
+	  "to enter        "}, 0, {{0, 0, 0}}},
+	/* SCREEN_LOCKING */
+	{{"Door Locking    ",
+	  "Please wait     "}, 0, {{0, 0, 0}}},
+	/* SCREEN_ADMIN */
+	{{"Pass:  Tries:   ",
+	  "Door:   s L:   s"}, 4, {{0, 5, 1}, {0, 13, 3}, {1, 5, 3}, {1, 12, 3}}},
+	/* SCREEN_MISMATCH */
+	{{"Passwords don't ",
+	  "match, try again"}, 0, {{0, 0, 0}}},
+	/* SCREEN_LINK_ERROR */
+	{{"No answer from  ",
+	  "the door, retry "}, 0, {{0, 0, 0}}},
+	/* SCREEN_CHANGE_FAILED */
+	{{"Password not    ",
+	  "changed         "}, 0, {{0, 0, 0}}},
+	/* SCREEN_RETYPE_PASS */
+	{{"Keys were lost  ",
+	  "Retype:         "}, 1, {{1, 8, CONFIG_PASSWORD_MAX_LENGTH}}},
+	/* SCREEN_DOOR_BUSY */
+	{{"Door is busy,   ",
+	  "try again later "}, 0, {{0, 0, 0}}},
+};
+
+/* Template shown, for its fields */
+static Screen_IdType g_screen = SCREEN_HOME;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Screen_show(Screen_IdType id)
+{
+	const Screen_TemplateType *screen = &g_screens[id];
+	uint8 row;
+	uint8 col;
+
+	g_screen = id;
+	for(row = 0; row < SCREEN_ROWS; row++)
+	{
+		LcdFb_moveCursor(row, 0);
+		for(col = 0; col < SCREEN_COLS; col++)
+		{
+			LcdFb_displayCharacter(pgm_read_byte(&screen->image[row][col]));
+		}
+	}
+
+	if(pgm_read_byte(&screen->fields) != 0)
+	{
+		LcdFb_moveCursor(pgm_read_byte(&screen->field[0].row), pgm_read_byte(&screen->field[0].col));
+	}
+}
+
+void Screen_setNumber(uint8 field, uint16 value)
+{
+	const Screen_TemplateType *screen = &g_screens[g_screen];
+	uint8 row;
+	uint8 col;
+	uint8 width;
+	uint8 i;
+
+	if(field >= pgm_read_byte(&screen->fields))
+	{
+		return;
+	}
+	row = pgm_read_byte(&screen->field[field].row);
+	col = pgm_read_byte(&screen->field[field].col);
+	width = pgm_read_byte(&screen->field[field].width);
+
+	/* Blank the field, then the digits from the last one */
+	LcdFb_moveCursor(row, col);
+	for(i = 0; i < width; i++)
+	{
+		LcdFb_displayCharacter(' ');
+	}
+	do
+	{
+		width--;
+		LcdFb_moveCursor(row, col + width);
+		LcdFb_displayCharacter('0' + (value % 10));
+		value /= 10;
+	} while((value != 0) && (width != 0));
+}
@@ -0,0 +1,79 @@
+ /******************************************************************************
+ *
+ * Module: SCREEN
+ *
+ * File Name: screen.h
+ *
+ * Description: Header file for the screen templates of the HMI
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef SCREEN_H_
+#define SCREEN_H_
+
+#include "std_types.h"
+#include "lcd_fb.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Size of the templates, drawn from the top left corner of the framebuffer */
+#define SCREEN_ROWS                 2
+#define SCREEN_COLS                 16
+
+#if((SCREEN_ROWS > LCD_FB_ROWS) || (SCREEN_COLS > LCD_FB_COLS))
+
+#error "The screen templates don't fit in the LCD framebuffer"
+
+#endif
+
+/* Fields patched in a template at most */
+#define SCREEN_MAX_FIELDS           4
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Templates, their image is in screen.c */
+typedef enum
+{
+	SCREEN_HOME,            /* menu */
+	SCREEN_ENTER_PASS,      /* field 0: the password, typed at the cursor */
+	SCREEN_REENTER_PASS,    /* field 0: the password, typed at the cursor */
+	SCREEN_OLD_PASS,        /* field 0: the password, typed at the cursor */
+	SCREEN_LOCKED,          /* field 0: seconds left */
+	SCREEN_UNLOCKING,
+	SCREEN_WAIT_PEOPLE,
+	SCREEN_LOCKING,
+	SCREEN_ADMIN,           /* fields: password length, attempts, door and lockout durations */
+	SCREEN_MISMATCH,
+	SCREEN_LINK_ERROR,
+	SCREEN_CHANGE_FAILED,
+	SCREEN_RETYPE_PASS,     /* field 0: the password, typed at the cursor */
+	SCREEN_DOOR_BUSY,
+	SCREEN_COUNT
+}Screen_IdType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Copy the whole image of a template from the flash to the framebuffer, the
+ * fields blank, and move the cursor of the framebuffer to the first field.
+ * No clear is needed before: every cell of the template is written.
+ */
+void Screen_show(Screen_IdType id);
+
+/*
+ * Description :
+ * Write a decimal value in a field of the template shown, right aligned. The
+ * digits that don't fit in the field are lost, the highest ones first.
+ */
+void Screen_setNumber(uint8 field, uint16 value);
+
+#endif /* SCREEN_H_ */
@@ -0,0 +1,200 @@
+ /******************************************************************************
+ *
+ * Module: SUPERVISOR
+ *
+ * File Name: supervisor.c
+ *
+ * Description: Source file for the watchdog supervisor of the tasks
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "supervisor.h"
+#include "timer.h"
+#include <avr/io.h>
+#include <avr/wdt.h>
+#include <avr/eeprom.h>
+
+/*******************************************************************************
+ *                      Preprocessor Macros                                    *
+ *******************************************************************************/
+
+/* A missed check costs one period, the watchdog must wait for several of them */
+#define SUPERVISOR_WATCHDOG_TIMEOUT     WDTO_1S
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/*
+ * Written by the tasks (TRUE) and by the check (FALSE): one byte each, and the
+ * check runs in an interrupt so a check-in can't come in the middle of it.
+ */
+static volatile uint8 g_alive[SUPERVISOR_MAX_TASKS];
+
+/* Only used by the check, in number of checks */
+static uint8 g_periods[SUPERVISOR_MAX_TASKS];
+static uint8 g_remaining[SUPERVISOR_MAX_TASKS];
+
+static uint8 g_count = 0;
+static volatile uint8 g_running = SUPERVISOR_NO_TASK;
+static uint8 g_failed = FALSE;
+
+/*
+ * Culprit of the last miss, in .noinit: kept across the watchdog reset, so the
+ * check doesn't write the EEPROM from its interrupt. Only missed, running and
+ * state are used. If the bootloader used this RAM before starting the application
+ * the mark is lost: the reset is still logged, without its culprit.
+ */
+static Supervisor_RecordType g_pending __attribute__((section(".noinit")));
+static volatile uint8 g_suspended = FALSE;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Timer1 compare match callback: age the deadlines and reset the watchdog if
+ * every task checked in in time.
+ */
+static void Supervisor_check(void);
+
+/*
+ * Write the record of a reset with its culprit.
+ */
+static void Supervisor_saveRecord(uint8 missed, uint8 running);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Supervisor_init(void)
+{
+	if(MCUCSR & (1 << WDRF))
+	{
+		if(g_pending.state == SUPERVISOR_RECORD_PENDING)
+		{
+			/* Kept by the check just before this reset */
+			Supervisor_saveRecord(g_pending.missed, g_pending.running);
+		}
+		else
+		{
+			/* The check could not run: the interrupts were disabled */
+			Supervisor_saveRecord(SUPERVISOR_NO_TASK, SUPERVISOR_NO_TASK);
+		}
+	}
+	g_pending.state = 0; /* Random after a power on */
+	MCUCSR = 0;
+}
+
+uint8 Supervisor_register(uint16 deadline_ms)
+{
+	uint8 id;
+
+	if(g_count == SUPERVISOR_MAX_TASKS)
+	{
+		return SUPERVISOR_NO_TASK;
+	}
+	id = g_count++;
+
+	/* One more check: the check-in can come just after a check */
+	g_periods[id] = (uint8)((deadline_ms + SUPERVISOR_CHECK_MS - 1) / SUPERVISOR_CHECK_MS) + 1;
+	g_remaining[id] = g_periods[id];
+	g_alive[id] = FALSE;
+	return id;
+}
+
+void Supervisor_checkIn(uint8 id)
+{
+	if(id < SUPERVISOR_MAX_TASKS)
+	{
+		g_alive[id] = TRUE;
+	}
+}
+
+void Supervisor_setRunning(uint8 id)
+{
+	g_running = id;
+}
+
+void Supervisor_start(void)
+{
+	static const Timer_ConfigType check_timer_config =
+			TIMER_CTC_CONFIG(TIMER1_ID, SUPERVISOR_CHECK_MS * 1000UL);
+
+	Timer_setCallBack(Supervisor_check, TIMER1_ID);
+	Timer_init(&check_timer_config);
+	wdt_enable(SUPERVISOR_WATCHDOG_TIMEOUT);
+}
+
+void Supervisor_suspend(void)
+{
+	g_suspended = TRUE;
+}
+
+void Supervisor_resume(void)
+{
+	uint8 id;
+
+	/* Alive: the next check gives every task its whole deadline */
+	for(id = 0; id < g_count; id++)
+	{
+		g_alive[id] = TRUE;
+	}
+	g_suspended = FALSE;
+}
+
+static void Supervisor_check(void)
+{
+	uint8 id;
+
+	if(g_failed)
+	{
+		return;
+	}
+	if(g_suspended)
+	{
+		wdt_reset();
+		return;
+	}
+
+	for(id = 0; id < g_count; id++)
+	{
+		if(g_alive[id])
+		{
+			g_alive[id] = FALSE;
+			g_remaining[id] = g_periods[id];
+		}
+		else if(--g_remaining[id] == 0)
+		{
+			g_pending.missed = id;
+			g_pending.running = g_running;
+			g_pending.state = SUPERVISOR_RECORD_PENDING;
+			g_failed = TRUE;
+			/* Nothing else to do, reset now */
+			wdt_enable(WDTO_15MS);
+			return;
+		}
+	}
+	wdt_reset();
+}
+
+static void Supervisor_saveRecord(uint8 missed, uint8 running)
+{
+	Supervisor_RecordType record;
+
+	eeprom_read_block(&record, (const void *)SUPERVISOR_RECORD_ADDRESS, sizeof(record));
+	if(record.state == 0xFF)
+	{
+		record.resets = 0; /* Erased EEPROM */
+	}
+	if(record.resets != 0xFF)
+	{
+		record.resets++;
+	}
+	record.missed = missed;
+	record.running = running;
+	record.state = SUPERVISOR_RECORD_LOGGED;
+	eeprom_update_block(&record, (void *)SUPERVISOR_RECORD_ADDRESS, sizeof(record));
+}
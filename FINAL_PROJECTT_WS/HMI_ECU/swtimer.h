@@ -0,0 +1,84 @@
+ /******************************************************************************
+ *
+ * Module: SWTIMER
+ *
+ * File Name: swtimer.h
+ *
+ * Description: Header file for the software timers (hashed timing wheel on the system tick)
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef SWTIMER_H_
+#define SWTIMER_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Number of slots of the wheel (power of 2), one slot per tick.
+ * A timer further than one turn stays in its slot and is skipped until its turn.
+ */
+#define SWTIMER_WHEEL_SIZE      64
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * The timers are owned by the application (static variables), the wheel only links
+ * them, so there is no limit on their number other than RAM (16 bytes each).
+ * A zero initialized timer is stopped. Only use the API to change the fields.
+ */
+typedef struct SwTimer_Type
+{
+	struct SwTimer_Type *next;
+	struct SwTimer_Type *prev;
+	uint32 expiry;                  /* tick of the next expiry */
+	uint32 period;                  /* 0 for a one-shot timer */
+	void (*callback)(void *context);
+	void *context;
+}SwTimer_Type;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Empty the wheel, the system tick must be running.
+ */
+void SwTimer_init(void);
+
+/*
+ * Description :
+ * Start (or restart) a timer, O(1). The callback is called from SwTimer_process()
+ * delay_ms after now, then every period_ms if period_ms is not 0.
+ */
+void SwTimer_start(SwTimer_Type *timer, uint32 delay_ms, uint32 period_ms,
+		void (*callback)(void *context), void *context);
+
+/*
+ * Description :
+ * Stop a timer, O(1). Nothing happens if it is not running.
+ */
+void SwTimer_cancel(SwTimer_Type *timer);
+
+/*
+ * Description :
+ * Return TRUE if the timer is running.
+ */
+uint8 SwTimer_isRunning(const SwTimer_Type *timer);
+
+/*
+ * Description :
+ * Call the callbacks of the expired timers, to be called from the main loop.
+ * Every tick since the last call is handled, an empty slot only costs a bit test.
+ */
+void SwTimer_process(void);
+
+#endif /* SWTIMER_H_ */
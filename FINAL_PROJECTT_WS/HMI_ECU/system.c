@@ -0,0 +1,49 @@
+ /******************************************************************************
+ *
+ * Module: SYSTEM
+ *
+ * File Name: system.c
+ *
+ * Description: Source file for the system services: time base, software timers and idle sleep
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#include "system.h"
+#include "swtimer.h"
+#include <avr/sleep.h>
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void System_init(void)
+{
+	Tick_init();
+	SwTimer_init();
+	set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+void System_sleep(void)
+{
+	/*
+	 * An interrupt between the caller's check and the sleep is not lost: the next
+	 * tick wakes the CPU up, so a wait ends at most one millisecond late.
+	 */
+	sleep_mode();
+}
+
+void System_idle(void)
+{
+	SwTimer_process();
+	System_sleep();
+}
+
+void System_waitUntil(uint32 deadline)
+{
+	while(!Tick_isExpired(deadline))
+	{
+		System_idle();
+	}
+}
@@ -0,0 +1,36 @@
+ /******************************************************************************
+ *
+ * Module: TIMER
+ *
+ * File Name: timer_cfg.h
+ *
+ * Description: Compile time binding of the timer interrupts to their handlers
+ *
+ * Author: Hassan
+ *
+ *******************************************************************************/
+
+#ifndef TIMER_CFG_H_
+#define TIMER_CFG_H_
+
+#include "tick.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * A vector with a handler defined here calls it directly, the handler should be a
+ * static inline function so its body is compiled in the ISR: no load of a volatile
+ * pointer, no NULL check, no indirect call and only the registers it uses saved.
+ * The other vectors keep the callback set by Timer_setCallBack().
+ *
+ * TIMER0_COMP_STATIC_HANDLER      TIMER0_OVF_STATIC_HANDLER
+ * TIMER1_COMPA_STATIC_HANDLER     TIMER1_OVF_STATIC_HANDLER
+ * TIMER2_COMP_STATIC_HANDLER      TIMER2_OVF_STATIC_HANDLER
+ */
+
+/* System tick (1 ms compare match) */
+#define TIMER2_COMP_STATIC_HANDLER      Tick_handler
+
+#endif /* TIMER_CFG_H_ */